@@ -0,0 +1,134 @@
+/*
+ * Burst.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Burst.h"
+#include "FRAM.h"
+#include "Telemetry.h"
+
+// Sample buffer in program FRAM, written with FRAM::write()
+// and read through a volatile pointer (the compiler must not
+// assume the initial zeros).
+static const BurstSample buffer[BURST_MAX_SAMPLES] = {{0, 0, 0}};
+static const volatile BurstSample *samples = buffer;
+
+Burst::Burst()
+  : startTime(0), duration(0), count(0), errors(0), dumped(0), sampling(false), dumping(false) {
+}
+
+//*********************************************************
+// Start a new burst, samples of the last one are dropped
+//
+// input:   seconds     duration, limited by BURST_MAX_SECONDS
+//                      and the size of the buffer
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Burst::start(uint8_t seconds) {
+
+  if(seconds > BURST_MAX_SECONDS)
+    seconds = BURST_MAX_SECONDS;
+  duration = (unsigned long)seconds * 1000;
+  startTime = millis();
+  count = 0;
+  errors = 0;
+  dumped = 0;
+  sampling = true;
+  dumping = false;
+}
+
+boolean Burst::isSampling(void) {
+
+  return sampling;
+}
+
+//*********************************************************
+// Store one sample
+//
+// input:   valid       checksum of the sensor data was correct
+//          h2          raw H2 signal
+//          ethanol     raw ethanol signal
+//
+// output:  none
+//
+// return:  false when the burst is over (time or buffer)
+//*********************************************************
+boolean Burst::store(boolean valid, unsigned int h2, unsigned int ethanol) {
+
+  unsigned long elapsed = millis() - startTime;
+
+  if(elapsed >= duration) {
+    sampling = false;
+    dumping = true;
+    return false;
+  }
+  if(!valid) {
+    errors++;
+    return true;
+  }
+
+  BurstSample sample;
+  sample.time = elapsed;
+  sample.h2 = h2;
+  sample.ethanol = ethanol;
+  FRAM::write((uint16_t)(uintptr_t)&buffer[count], &sample, sizeof(sample));
+
+  if(++count >= BURST_MAX_SAMPLES) {
+    sampling = false;
+    dumping = true;
+  }
+  return sampling;
+}
+
+// End the burst early, the samples so far are dumped
+void Burst::stop(void) {
+
+  if(!sampling)
+    return;
+  sampling = false;
+  dumping = true;
+}
+
+boolean Burst::isDumping(void) {
+
+  return dumping;
+}
+
+//*********************************************************
+// Encode the next dump frame
+//
+// input:   none
+//
+// output:  *payload    payload of a TELEMETRY_FRAME_BURST
+//
+// return:  length of the payload, 0 if everything is sent
+//          (at least one frame, even without samples)
+//*********************************************************
+uint8_t Burst::encodeDump(uint8_t *payload) {
+
+  if(!isDumping())
+    return 0;
+
+  uint8_t n = 0;
+  Telemetry::putUInt16(payload, dumped);
+  Telemetry::putUInt16(payload + 2, count);
+  Telemetry::putUInt16(payload + 4, errors);
+
+  uint8_t *p = payload + BURST_FRAME_HEADER;
+  while(n < BURST_SAMPLES_PER_FRAME && dumped < count) {
+    Telemetry::putUInt16(p, samples[dumped].time);
+    Telemetry::putUInt16(p + 2, samples[dumped].h2);
+    Telemetry::putUInt16(p + 4, samples[dumped].ethanol);
+    p += BURST_SAMPLE_SIZE;
+    dumped++;
+    n++;
+  }
+  if(dumped >= count)
+    dumping = false;
+  return BURST_FRAME_HEADER + n * BURST_SAMPLE_SIZE;
+}
@@ -0,0 +1,73 @@
+/*
+ * Burst.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef BURST_H_
+#define BURST_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+//***************************
+// Raw signal burst of the SGP30
+//
+// Samples H2 and ethanol signals (measure_raw_signals)
+// back to back into a buffer in program FRAM. Per
+// sample only the I2C read, the checksum and a 6-byte
+// FRAM write are done; display and serial interface
+// stay quiet until the burst is over.
+//
+// 256 samples take 1.5 KB of FRAM and last about 7 s
+// at the maximal rate (25 ms per measurement).
+//***************************
+#define BURST_MAX_SAMPLES         256
+#define BURST_MAX_SECONDS         60
+
+//***************************
+// Dump payload (TELEMETRY_FRAME_BURST)
+//
+// [INDEX (2)][TOTAL (2)][ERRORS (2)][SAMPLE (6) ...]
+//
+// INDEX     index of the first sample in this frame
+// TOTAL     count of samples in the burst
+// ERRORS    samples dropped because of a wrong checksum
+// SAMPLE    [TIME (2)][H2 (2)][ETHANOL (2)]
+//           TIME in ms since the start of the burst
+//***************************
+#define BURST_FRAME_HEADER        6
+#define BURST_SAMPLE_SIZE         6
+#define BURST_SAMPLES_PER_FRAME   5
+
+struct BurstSample {
+  uint16_t time;
+  uint16_t h2;
+  uint16_t ethanol;
+};
+
+//***************************
+// Methods
+//***************************
+class Burst {
+  private:
+    unsigned long startTime;
+    unsigned long duration;
+    uint16_t count;
+    uint16_t errors;
+    uint16_t dumped;
+    boolean sampling;
+    boolean dumping;
+
+  public:
+    Burst();
+    void start(uint8_t seconds);
+    boolean isSampling(void);
+    boolean store(boolean valid, unsigned int h2, unsigned int ethanol);
+    void stop(void);
+    boolean isDumping(void);
+    uint8_t encodeDump(uint8_t *payload);
+};
+
+#endif /* BURST_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Config.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Config.h"
+#include "FRAM.h"
+#include "GUI.h"
+#include "SHT21.h"
+#include "crc.h"
+
+// Object of CRC calculation
+extern CRC crc;
+
+// The layout is shared with the host, no padding allowed
+typedef char configBlockSize[sizeof(ConfigBlock) == CONFIG_BLOCK_SIZE ? 1 : -1];
+
+static const ConfigBlock defaults = {
+  CONFIG_MAGIC, CONFIG_VERSION, 0,
+  CONFIG_DEFAULT_SHT21_INTERVAL, CONFIG_DEFAULT_SGP30_INTERVAL,
+  SHT21_RESOLUTION_12_14, 0, 0, CONFIG_TELEMETRY_READINGS, 1,
+  CONFIG_DEFAULT_SCREEN, CONFIG_DEFAULT_LOG_INTERVAL, 0
+};
+
+static const ConfigBlock *slotA = (const ConfigBlock *)FRAM_CONFIG_A;
+static const ConfigBlock *slotB = (const ConfigBlock *)FRAM_CONFIG_B;
+static const ConfigBlock *current = &defaults;
+
+//*********************************************************
+// Check a block from FRAM or the serial interface
+//
+// input:   *block      configuration to check
+//
+// output:  none
+//
+// return:  true if magic, version, CRC and all values are
+//          correct
+//*********************************************************
+bool Config::isValid(const ConfigBlock *block) {
+
+  if(block->magic != CONFIG_MAGIC || block->version != CONFIG_VERSION)
+    return false;
+  if(crc.Fast((const uint8_t *)block, sizeof(ConfigBlock) - 1) != block->crc)
+    return false;
+
+  return block->sht21Interval >= CONFIG_MIN_SHT21_INTERVAL &&
+         block->sgp30Interval == CONFIG_SGP30_INTERVAL &&
+         (block->sht21Resolution & ~SHT21_RESOLUTION_MASK) == 0 &&
+         block->filterShift <= CONFIG_MAX_FILTER_SHIFT &&
+         block->telemetryMode <= CONFIG_TELEMETRY_READINGS &&
+         block->telemetryDivider > 0 &&
+         block->screen >= SCREEN_CO2 && block->screen <= SCREEN_RH;
+}
+
+//*********************************************************
+// Select the stored configuration, called once at boot
+// Only the CRCs are checked, the block is used in place.
+//
+// input:   none
+//
+// output:  none
+//
+// return:  active configuration
+//*********************************************************
+const ConfigBlock *Config::begin(void) {
+
+  bool a = isValid(slotA);
+  bool b = isValid(slotB);
+
+  if(a && b)
+    current = (int8_t)(slotA->sequence - slotB->sequence) > 0 ? slotA : slotB;
+  else if(a)
+    current = slotA;
+  else if(b)
+    current = slotB;
+  else
+    current = &defaults;
+  return current;
+}
+
+const ConfigBlock *Config::active(void) {
+
+  return current;
+}
+
+//*********************************************************
+// Store a new configuration
+// The block goes into the slot that isn't in use. It
+// becomes active only if it reads back correctly.
+//
+// input:   *update     new values; magic, sequence and CRC
+//                      are set here
+//
+// output:  none
+//
+// return:  false if the values are invalid or the write
+//          failed, the old configuration stays active
+//*********************************************************
+bool Config::commit(const ConfigBlock *update) {
+
+  ConfigBlock block = *update;
+  const ConfigBlock *slot = (current == slotA) ? slotB : slotA;
+
+  block.magic = CONFIG_MAGIC;
+  block.sequence = current->sequence + 1;
+  block.crc = crc.Fast((const uint8_t *)&block, sizeof(block) - 1);
+  if(!isValid(&block))
+    return false;
+
+  FRAM::write((uint16_t)(uintptr_t)slot, &block, sizeof(block));
+  if(!isValid(slot))
+    return false;
+  current = slot;
+  return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * Config.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stdint.h>
+
+//***************************
+// Configuration in the information FRAM
+//
+// Two slots hold a ConfigBlock each. The block with a
+// valid CRC and the higher sequence number is used in
+// place, there's nothing to parse at boot. An update
+// is written into the other slot, so a reset during the
+// write leaves the old block intact. Without a valid
+// block, the defaults below are used.
+//
+// The block is sent as it is over the serial interface
+// (TELEMETRY_COMMAND_CONFIG), so its layout must only
+// change together with CONFIG_VERSION.
+//***************************
+#define CONFIG_MAGIC              0xC0F1
+#define CONFIG_VERSION            2
+
+//***************************
+// Defaults, used until a configuration is stored
+//***************************
+#define CONFIG_DEFAULT_SHT21_INTERVAL   500       // ms
+#define CONFIG_DEFAULT_SGP30_INTERVAL   CONFIG_SGP30_INTERVAL
+#define CONFIG_DEFAULT_SCREEN           1         // SCREEN_CO2
+#define CONFIG_DEFAULT_LOG_INTERVAL     15        // min, 32 hours in the log
+
+// Limits of the intervals
+#define CONFIG_MIN_SHT21_INTERVAL       200       // both conversions take 114 ms
+#define CONFIG_SGP30_INTERVAL           1000      // only value, the dynamic baseline compensation
+                                                  // needs measure_iaq exactly every second
+#define CONFIG_MAX_FILTER_SHIFT         6
+
+// Telemetry modes (only with TELEMETRY in main.ino)
+#define CONFIG_TELEMETRY_OFF            0         // commands only
+#define CONFIG_TELEMETRY_READINGS       1         // every n-th reading
+
+struct ConfigBlock {
+  uint16_t magic;             // CONFIG_MAGIC
+  uint8_t version;            // CONFIG_VERSION
+  uint8_t sequence;           // incremented with every update
+  uint16_t sht21Interval;     // ms between two SHT21 measurements
+  uint16_t sgp30Interval;     // ms between two air quality measurements (CONFIG_SGP30_INTERVAL)
+  uint8_t sht21Resolution;    // SHT21_RESOLUTION_xxx
+  uint8_t filterShift;        // low-pass of the values: new = old + (value - old) / 2^n, 0 = off
+  uint8_t maxWindow;          // minutes until the maximal values restart, 0 = never
+  uint8_t telemetryMode;      // CONFIG_TELEMETRY_xxx
+  uint8_t telemetryDivider;   // send every n-th reading
+  uint8_t screen;             // screen after reset (SCREEN_xxx)
+  uint8_t logInterval;        // minutes between two records of the log (RecordLog.h), 0 = off
+  uint8_t crc;                // CRC-8 over all bytes before
+} __attribute__((packed));
+
+#define CONFIG_BLOCK_SIZE         16
+
+//***************************
+// Methods
+//***************************
+class Config {
+  public:
+    static const ConfigBlock *begin(void);
+    static const ConfigBlock *active(void);
+    static bool isValid(const ConfigBlock *block);
+    static bool commit(const ConfigBlock *update);
+};
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,169 @@
+/*
+ * Energy.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Energy.h"
+#include "Telemetry.h"
+
+static const EnergyModel defaultModel = {
+  {ENERGY_CPU_ACTIVE, ENERGY_I2C_ACTIVE, ENERGY_SHT21_ACTIVE, ENERGY_SGP30_ACTIVE, ENERGY_LCD_ACTIVE},
+  {ENERGY_CPU_IDLE, ENERGY_I2C_IDLE, ENERGY_SHT21_IDLE, ENERGY_SGP30_IDLE, ENERGY_LCD_IDLE},
+};
+
+Energy::Energy()
+  : model(&defaultModel), lastUpdate(0), lastBusy(0), lastConversion(0), lastHeater(0),
+    sleepTime(0), elapsed(0) {
+
+  for(uint8_t i = 0; i < ENERGY_COMPONENTS; i++) {
+    active[i] = 0;
+  }
+}
+
+// Start counting now, the driver counters start at 0
+void Energy::begin(void) {
+
+  lastUpdate = millis();
+}
+
+//*********************************************************
+// Use other currents, e.g. measured ones
+//
+// input:   *currents   model, must stay valid
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Energy::setModel(const EnergyModel *currents) {
+
+  model = currents;
+}
+
+const EnergyModel *Energy::getModel(void) {
+
+  return model;
+}
+
+//*********************************************************
+// Low power mode for the given time, counted as idle time
+// of the CPU. A button wakes up early.
+//
+// input:   ms          maximal sleep time
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Energy::sleep(unsigned long ms) {
+
+  unsigned long start = millis();
+
+  ::sleep(ms);
+  sleepTime += millis() - start;
+}
+
+// Idle time of the CPU spent elsewhere
+void Energy::addSleep(unsigned long ms) {
+
+  sleepTime += ms;
+}
+
+//*********************************************************
+// Add the time since the last update
+// Must be called more often than the driver counters wrap
+// around (71 minutes for the I2C time).
+//
+// input:   busyTime        I2CBus::getBusyTime() in us
+//          conversionTime  SHT21::getConversionTime() in ms
+//          heaterTime      SGP30::getHeaterTime() in ms
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Energy::update(unsigned long busyTime, unsigned long conversionTime, unsigned long heaterTime) {
+
+  unsigned long now = millis();
+  uint64_t period = (uint64_t)(now - lastUpdate) * 1000;
+  uint64_t idle = (uint64_t)sleepTime * 1000;
+
+  elapsed += period;
+  active[ENERGY_CPU] += idle < period ? period - idle : 0;
+  active[ENERGY_I2C] += busyTime - lastBusy;
+  active[ENERGY_SHT21] += (uint64_t)(conversionTime - lastConversion) * 1000;
+  active[ENERGY_SGP30] += (uint64_t)(heaterTime - lastHeater) * 1000;
+  active[ENERGY_LCD] += period;
+
+  lastUpdate = now;
+  lastBusy = busyTime;
+  lastConversion = conversionTime;
+  lastHeater = heaterTime;
+  sleepTime = 0;
+}
+
+// Time since the reset in ms
+uint32_t Energy::getElapsed(void) {
+
+  return elapsed / 1000;
+}
+
+// Active time of a component in ms
+uint32_t Energy::getActive(uint8_t component) {
+
+  return active[component] / 1000;
+}
+
+//*********************************************************
+// Average current of a component since the reset
+//
+// input:   component   ENERGY_xxx
+//
+// output:  none
+//
+// return:  current in nA (= nAh per hour)
+//*********************************************************
+uint32_t Energy::averageCurrent(uint8_t component) {
+
+  if(elapsed == 0)
+    return 0;
+  // Active time can't exceed the elapsed time, but the
+  // counters of the drivers are updated independently
+  uint64_t on = active[component] < elapsed ? active[component] : elapsed;
+  // uA * us, a year at 65 mA still fits
+  uint64_t charge = on * model->active[component] + (elapsed - on) * model->idle[component];
+  uint64_t remainder = charge % elapsed;
+  return (charge / elapsed) * 1000 + (remainder * 1000 + elapsed / 2) / elapsed;
+}
+
+// Average current of all components in nA
+uint32_t Energy::averageCurrent(void) {
+
+  uint32_t sum = 0;
+
+  for(uint8_t i = 0; i < ENERGY_COMPONENTS; i++) {
+    sum += averageCurrent(i);
+  }
+  return sum;
+}
+
+//*********************************************************
+// Build the payload of an energy frame
+//
+// input:   none
+//
+// output:  *payload    ENERGY_REPORT_SIZE bytes
+//
+// return:  size of the payload
+//*********************************************************
+uint8_t Energy::encodeReport(uint8_t *payload) {
+
+  Telemetry::putUInt32(payload, getElapsed());
+  for(uint8_t i = 0; i < ENERGY_COMPONENTS; i++) {
+    Telemetry::putUInt32(&payload[4 + 4 * i], getActive(i));
+  }
+  Telemetry::putUInt32(&payload[4 + 4 * ENERGY_COMPONENTS], averageCurrent());
+  return ENERGY_REPORT_SIZE;
+}
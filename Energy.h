@@ -0,0 +1,91 @@
+/*
+ * Energy.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+//***************************
+// Energy accounting
+//
+// The drivers count how long their part draws its active
+// current: the I2C bus during transactions, the SHT21
+// during conversions and the SGP30 while the hot plate is
+// on. The CPU is active whenever loop() doesn't sleep,
+// the LCD is always on. The rest of the time every part
+// draws its low power current.
+//
+// Charge = sum of active time * active current
+//              + low power time * low power current
+//
+// The average current in nA is the charge in nAh per hour.
+//***************************
+enum {
+  ENERGY_CPU, ENERGY_I2C, ENERGY_SHT21, ENERGY_SGP30, ENERGY_LCD, ENERGY_COMPONENTS
+};
+
+// Current model, typical values of the datasheets in uA
+#define ENERGY_CPU_ACTIVE         1100      // 8 MHz, FRAM
+#define ENERGY_CPU_IDLE           1         // LPM3, RTC on VLO
+#define ENERGY_I2C_ACTIVE         330       // 10k pull-ups, half the time low
+#define ENERGY_I2C_IDLE           0
+#define ENERGY_SHT21_ACTIVE       300
+#define ENERGY_SHT21_IDLE         0         // 0.15 uA
+#define ENERGY_SGP30_ACTIVE       48200
+#define ENERGY_SGP30_IDLE         2         // sleep mode
+#define ENERGY_LCD_ACTIVE         4         // static, charge pump off
+#define ENERGY_LCD_IDLE           0
+
+struct EnergyModel {
+  uint16_t active[ENERGY_COMPONENTS];   // uA
+  uint16_t idle[ENERGY_COMPONENTS];     // uA
+};
+
+//***************************
+// Energy payload (TELEMETRY_FRAME_ENERGY)
+//
+// [ELAPSED (4)][CPU (4)][I2C (4)][SHT21 (4)][SGP30 (4)][LCD (4)][AVERAGE (4)]
+//
+// ELAPSED   ms since the reset
+// CPU..LCD  active time in ms, low power time is the rest
+// AVERAGE   average current in nA since the reset
+//***************************
+#define ENERGY_REPORT_SIZE        28
+#define ENERGY_REPORT_INTERVAL    60000     // ms
+
+//***************************
+// Methods
+//***************************
+class Energy {
+  private:
+    const EnergyModel *model;
+    unsigned long lastUpdate;     // millis()
+    unsigned long lastBusy;       // counters of the drivers at
+    unsigned long lastConversion; // the last update
+    unsigned long lastHeater;
+    unsigned long sleepTime;      // ms since the last update
+    uint64_t elapsed;             // us
+    uint64_t active[ENERGY_COMPONENTS];
+
+  public:
+    Energy();
+    void begin(void);
+    void setModel(const EnergyModel *currents);
+    const EnergyModel *getModel(void);
+    void sleep(unsigned long ms);
+    void addSleep(unsigned long ms);
+    void update(unsigned long busyTime, unsigned long conversionTime, unsigned long heaterTime);
+    uint32_t getElapsed(void);
+    uint32_t getActive(uint8_t component);
+    uint32_t averageCurrent(uint8_t component);
+    uint32_t averageCurrent(void);
+    uint8_t encodeReport(uint8_t *payload);
+};
+
+#endif /* ENERGY_H_ */
@@ -0,0 +1,86 @@
+/*
+ * FRAM.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "FRAM.h"
+#include "crc.h"
+
+// Object of CRC calculation
+extern CRC crc;
+
+//*********************************************************
+// Write data into the information or program FRAM
+// The write protection is lifted only for the copy.
+//
+// input:   address     destination (FRAM_xxx or a const
+//                      array in program FRAM)
+//          *data       data to store
+//          length      count of bytes
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void FRAM::write(uint16_t address, const void *data, uint8_t length) {
+
+  const uint8_t *source = (const uint8_t *)data;
+  volatile uint8_t *destination = (volatile uint8_t *)address;
+
+  uint16_t protection = SYSCFG0 & 0x00FF;
+  uint16_t unlock = (address >= FRAM_INFO_START && address < FRAM_INFO_START + FRAM_INFO_SIZE) ? DFWP : PFWP;
+
+  SYSCFG0 = FRWPPW | (protection & ~unlock);
+  for(uint8_t i = 0; i < length; i++) {
+    destination[i] = source[i];
+  }
+  SYSCFG0 = FRWPPW | protection;
+}
+
+//*********************************************************
+// Store the latest measured values
+//
+// input:   co2           CO2 value in ppm
+//          tvoc          TVOC value in ppb
+//          temperature   temperature in 1/100 degree Celsius
+//          humidity      relative humidity in 1/100 percent
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void FRAM::saveReading(unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity) {
+
+  FRAMReading reading;
+
+  reading.magic = FRAM_READING_MAGIC;
+  reading.co2 = co2;
+  reading.tvoc = tvoc;
+  reading.temperature = temperature;
+  reading.humidity = humidity;
+  reading.reserved = 0;
+  reading.crc = crc.Fast((const uint8_t *)&reading, sizeof(reading) - 1);
+
+  write(FRAM_LAST_READING, &reading, sizeof(reading));
+}
+
+//*********************************************************
+// Values stored before the last reset
+//
+// input:   none
+//
+// output:  none
+//
+// return:  pointer into FRAM, 0 if nothing valid is stored
+//*********************************************************
+const FRAMReading *FRAM::lastReading(void) {
+
+  const FRAMReading *reading = (const FRAMReading *)FRAM_LAST_READING;
+
+  if(reading->magic != FRAM_READING_MAGIC ||
+     crc.Fast((const uint8_t *)reading, sizeof(FRAMReading) - 1) != reading->crc)
+    return 0;
+  return reading;
+}
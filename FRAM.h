@@ -0,0 +1,54 @@
+/*
+ * FRAM.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef FRAM_H_
+#define FRAM_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+//***************************
+// Information FRAM of the MSP430FR4133 (512 bytes)
+// Survives resets and power cycles, write protected by
+// SYSCFG0.DFWP. Records are read in place through the
+// pointers below, there's nothing to load at boot.
+//***************************
+#define FRAM_INFO_START           0x1800
+#define FRAM_INFO_SIZE            512
+
+// Layout of the information FRAM
+#define FRAM_LAST_READING         (FRAM_INFO_START + 0x000)     // FRAMReading
+#define FRAM_CONFIG_A             (FRAM_INFO_START + 0x010)     // ConfigBlock (Config.h)
+#define FRAM_CONFIG_B             (FRAM_INFO_START + 0x020)     // ConfigBlock
+#define FRAM_LOG_STATE            (FRAM_INFO_START + 0x030)     // LogState (RecordLog.h)
+
+//***************************
+// Last measured values, shown right after a reset
+//***************************
+#define FRAM_READING_MAGIC        0xC0A2
+
+struct FRAMReading {
+  uint16_t magic;
+  uint16_t co2;             // ppm
+  uint16_t tvoc;            // ppb
+  int16_t temperature;      // 1/100 degree Celsius
+  uint16_t humidity;        // 1/100 percent
+  uint8_t reserved;
+  uint8_t crc;              // CRC-8 over all bytes before
+};
+
+//***************************
+// Methods
+//***************************
+class FRAM {
+  public:
+    static void write(uint16_t address, const void *data, uint8_t length);
+    static void saveReading(unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity);
+    static const FRAMReading *lastReading(void);
+};
+
+#endif /* FRAM_H_ */
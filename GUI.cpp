@@ -58,7 +58,7 @@ void GUI::printFloat(float floatValue) {
 //
 // return:    none
 //**********************************************************************************
-void GUI::printInteger(uint16_t integerValue) {
+void GUI::printInteger(unsigned int integerValue) {
 
   char intStr[10];
   uint8_t numberLength;
@@ -96,7 +96,7 @@ void GUI::printInteger(uint16_t integerValue) {
 //
 // return:    none
 //**********************************************************************************
-void GUI::showCO2(uint16_t co2) {
+void GUI::showCO2(unsigned int co2) {
 
   lcd.clear();
   printInteger(co2);
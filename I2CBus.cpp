@@ -0,0 +1,203 @@
+/*
+ * I2CBus.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "I2CBus.h"
+
+I2CBus::I2CBus(uint8_t pinSDA, uint8_t pinSCL)
+  : I2CWire(pinSDA, pinSCL), sdaPin(pinSDA), sclPin(pinSCL),
+    failures(0), clearCount(0), lineError(false), transactionStart(0), busyTime(0) {
+}
+
+//*********************************************************
+// Check the lines before a transaction, clear the bus
+// if a slave still holds SDA or SCL low
+//
+// input:   none
+//
+// output:  none
+//
+// return:  false if the bus is still stuck
+//*********************************************************
+boolean I2CBus::ready(void) {
+
+  // A slave may still stretch the clock
+  if(waitForLine(sclPin, I2C_STRETCH_TIMEOUT) && digitalRead(sdaPin) == HIGH)
+    return true;
+  return clear();
+}
+
+//*********************************************************
+// Wait until a slave releases a line
+//
+// input:   pin         SDA or SCL
+//          timeout     us
+//
+// output:  none
+//
+// return:  false if the line is still low
+//*********************************************************
+boolean I2CBus::waitForLine(uint8_t pin, unsigned long timeout) {
+
+  unsigned long start = micros();
+
+  while(digitalRead(pin) == LOW) {
+    if(micros() - start >= timeout)
+      return false;
+  }
+  return true;
+}
+
+//*********************************************************
+// Count failed transactions
+//
+// input:   ok          transaction was acknowledged and
+//                      returned all bytes
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void I2CBus::result(boolean ok) {
+
+#if defined(I2C_TRACE)
+  // Without the trace frame sent afterwards
+  unsigned long duration = getTransferEnd() - transactionStart;
+#else
+  unsigned long duration = micros() - transactionStart;
+#endif
+
+  busyTime += duration;
+  if(lineError || duration > I2C_TRANSACTION_TIMEOUT)
+    ok = false;
+  lineError = false;
+
+  if(ok)
+    failures = 0;
+  else if(failures < 0xFF)
+    failures++;
+}
+
+void I2CBus::beginTransmission(uint8_t slaveAddress) {
+
+  lineError = !ready();
+  transactionStart = micros();
+  I2CWire::beginTransmission(slaveAddress);
+}
+
+uint8_t I2CBus::endTransmission(void) {
+
+  uint8_t status = I2CWire::endTransmission();
+  boolean stuck = lineError;
+
+  result(status == 0);
+  return stuck ? I2C_STATUS_BUS_ERROR : status;
+}
+
+uint8_t I2CBus::requestFrom(uint8_t slaveAddress, uint8_t quantity) {
+
+  lineError = !ready();
+  transactionStart = micros();
+  uint8_t count = I2CWire::requestFrom(slaveAddress, quantity);
+
+  result(count == quantity);
+  return count;
+}
+
+//*********************************************************
+// Open drain: lines are only pulled low or released
+//*********************************************************
+void I2CBus::releaseLine(uint8_t pin) {
+
+  pinMode(pin, INPUT_PULLUP);
+}
+
+void I2CBus::pullLine(uint8_t pin) {
+
+  digitalWrite(pin, LOW);
+  pinMode(pin, OUTPUT);
+}
+
+//*********************************************************
+// Both lines are high, no transaction is hanging
+//
+// input:   none
+//
+// output:  none
+//
+// return:  true if SDA and SCL are high
+//*********************************************************
+boolean I2CBus::isIdle(void) {
+
+  return digitalRead(sdaPin) == HIGH && digitalRead(sclPin) == HIGH;
+}
+
+//*********************************************************
+// Bus clear (I2C specification, 3.1.16)
+// Clocks SCL until the slave releases SDA (at most 9
+// pulses, one byte and the acknowledge), then sends a
+// STOP. The I2C library is initialized again afterwards.
+//
+// input:   none
+//
+// output:  none
+//
+// return:  true if both lines are high again
+//*********************************************************
+boolean I2CBus::clear(void) {
+
+  clearCount++;
+  releaseLine(sdaPin);
+  releaseLine(sclPin);
+  delayMicroseconds(I2C_HALF_PERIOD);
+
+  for(uint8_t i = 0; i < I2C_CLEAR_PULSES && digitalRead(sdaPin) == LOW; i++) {
+    pullLine(sclPin);
+    delayMicroseconds(I2C_HALF_PERIOD);
+    releaseLine(sclPin);
+    // Slave may stretch the clock, pulses can't help if it keeps SCL low
+    if(!waitForLine(sclPin, I2C_STRETCH_TIMEOUT))
+      break;
+    delayMicroseconds(I2C_HALF_PERIOD);
+  }
+
+  // STOP: SDA rises while SCL is high
+  pullLine(sdaPin);
+  delayMicroseconds(I2C_HALF_PERIOD);
+  releaseLine(sclPin);
+  delayMicroseconds(I2C_HALF_PERIOD);
+  releaseLine(sdaPin);
+  delayMicroseconds(I2C_HALF_PERIOD);
+
+  I2CWire::begin();
+  return isIdle();
+}
+
+boolean I2CBus::isHealthy(void) {
+
+  return failures < I2C_MAX_FAILURES;
+}
+
+uint8_t I2CBus::getFailures(void) {
+
+  return failures;
+}
+
+unsigned int I2CBus::getClearCount(void) {
+
+  return clearCount;
+}
+
+void I2CBus::resetFailures(void) {
+
+  failures = 0;
+}
+
+// Time spent in transactions (energy accounting)
+unsigned long I2CBus::getBusyTime(void) {
+
+  return busyTime;
+}
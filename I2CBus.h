@@ -0,0 +1,73 @@
+/*
+ * I2CBus.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef I2CBUS_H_
+#define I2CBUS_H_
+
+#include "Energia.h"
+#include <stdint.h>
+#include "I2CTrace.h"
+
+//***************************
+// Bus health
+//
+// Every transaction checks the lines first. A slave
+// holding SDA low (e.g. reset in the middle of a read)
+// is released by clocking SCL up to 9 times and sending
+// a STOP, which takes about 0.1 ms. Transactions that are
+// NACKed, return too few bytes or whose transfer took
+// longer than I2C_TRANSACTION_TIMEOUT count as failures;
+// the application re-initializes the sensors after
+// I2C_MAX_FAILURES in a row.
+//
+// The duration is checked afterwards, it can't stop a
+// transfer. Only the waits for a line in this class are
+// bounded, a transfer hanging in the I2C library is left
+// to the watchdog (see Watchdog.h).
+//***************************
+#define I2C_TRANSACTION_TIMEOUT   5000      // us, a 9-byte read takes about 1 ms
+#define I2C_MAX_FAILURES          3
+#define I2C_CLEAR_PULSES          9
+#define I2C_HALF_PERIOD           5         // us, 100 kHz
+#define I2C_STRETCH_TIMEOUT       1000      // us, SCL held low by a slave
+
+// Status of endTransmission() if the bus is stuck
+#define I2C_STATUS_BUS_ERROR      4
+
+//***************************
+// Methods
+//***************************
+class I2CBus : public I2CWire {
+  private:
+    uint8_t sdaPin;
+    uint8_t sclPin;
+    uint8_t failures;               // failed transactions in a row
+    unsigned int clearCount;
+    boolean lineError;              // lines stuck at the start
+    unsigned long transactionStart; // micros()
+    unsigned long busyTime;         // us in transactions, wraps around
+    boolean ready(void);
+    void result(boolean ok);
+    boolean waitForLine(uint8_t pin, unsigned long timeout);
+    void releaseLine(uint8_t pin);
+    void pullLine(uint8_t pin);
+
+  public:
+    I2CBus(uint8_t pinSDA, uint8_t pinSCL);
+    void beginTransmission(uint8_t slaveAddress);
+    uint8_t endTransmission(void);
+    uint8_t requestFrom(uint8_t slaveAddress, uint8_t quantity);
+    boolean isIdle(void);
+    boolean clear(void);
+    boolean isHealthy(void);
+    uint8_t getFailures(void);
+    unsigned int getClearCount(void);
+    void resetFailures(void);
+    unsigned long getBusyTime(void);
+};
+
+#endif /* I2CBUS_H_ */
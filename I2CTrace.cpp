@@ -0,0 +1,129 @@
+/*
+ * I2CTrace.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Energia.h"
+#include "I2CTrace.h"
+
+#if defined(I2C_TRACE)
+
+#include "Telemetry.h"
+
+// Object of telemetry output
+extern Telemetry telemetry;
+
+TraceWire::TraceWire(uint8_t pinSDA, uint8_t pinSCL)
+  : SoftwareWire(pinSDA, pinSCL), address(0), txLength(0), rxLength(0), rxIndex(0), transferEnd(0) {
+}
+
+//*********************************************************
+// Send one transaction as trace frame
+//
+// input:   direction   I2C_TRACE_WRITE or I2C_TRACE_READ
+//          status      result of the transaction
+//          *data       transferred bytes
+//          length      count of transferred bytes
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void TraceWire::record(uint8_t direction, uint8_t status, const uint8_t *data, uint8_t length) {
+
+  uint8_t payload[I2C_TRACE_RECORD_HEADER + I2C_TRACE_MAX_DATA];
+
+  Telemetry::putUInt32(payload, millis());
+  payload[4] = (address << 1) | direction;
+  payload[5] = status;
+  for(uint8_t i = 0; i < length; i++) {
+    payload[I2C_TRACE_RECORD_HEADER + i] = data[i];
+  }
+
+  telemetry.sendFrame(TELEMETRY_FRAME_TRACE, payload, I2C_TRACE_RECORD_HEADER + length);
+}
+
+void TraceWire::beginTransmission(uint8_t slaveAddress) {
+
+  address = slaveAddress;
+  txLength = 0;
+  SoftwareWire::beginTransmission(slaveAddress);
+}
+
+size_t TraceWire::write(uint8_t data) {
+
+  if(txLength < I2C_TRACE_MAX_DATA)
+    txBuffer[txLength++] = data;
+  return SoftwareWire::write(data);
+}
+
+size_t TraceWire::write(const uint8_t *data, size_t quantity) {
+
+  size_t written = 0;
+  for(size_t i = 0; i < quantity; i++) {
+    written += write(data[i]);
+  }
+  return written;
+}
+
+//*********************************************************
+// Finish a write transaction and record the sent bytes
+//
+// return:  status of SoftwareWire::endTransmission()
+//*********************************************************
+uint8_t TraceWire::endTransmission(void) {
+
+  uint8_t status = SoftwareWire::endTransmission();
+  transferEnd = micros();
+  record(I2C_TRACE_WRITE, status, txBuffer, txLength);
+  txLength = 0;
+  return status;
+}
+
+//*********************************************************
+// Perform a read transaction and record the received
+// bytes. The bytes are buffered here, so the drivers
+// read them through available()/read() as before.
+//
+// return:  count of received bytes
+//*********************************************************
+uint8_t TraceWire::requestFrom(uint8_t slaveAddress, uint8_t quantity) {
+
+  if(quantity > I2C_TRACE_MAX_DATA)
+    quantity = I2C_TRACE_MAX_DATA;
+
+  uint8_t received = SoftwareWire::requestFrom(slaveAddress, quantity);
+  transferEnd = micros();
+
+  rxLength = 0;
+  rxIndex = 0;
+  while(SoftwareWire::available() && rxLength < quantity) {
+    rxBuffer[rxLength++] = SoftwareWire::read();
+  }
+
+  address = slaveAddress;
+  record(I2C_TRACE_READ, received, rxBuffer, rxLength);
+  return received;
+}
+
+int TraceWire::available(void) {
+
+  return rxLength - rxIndex;
+}
+
+int TraceWire::read(void) {
+
+  if(rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+// End of the last transfer, before its record was sent
+unsigned long TraceWire::getTransferEnd(void) {
+
+  return transferEnd;
+}
+
+#endif
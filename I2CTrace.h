@@ -0,0 +1,75 @@
+/*
+ * I2CTrace.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef I2CTRACE_H_
+#define I2CTRACE_H_
+
+#include <stdint.h>
+#include "I2C_SoftwareLibrary.h"
+
+/*
+ * Uncomment this line to record every I2C transaction.
+ * Each transaction is sent as a TELEMETRY_FRAME_TRACE
+ * frame over the serial interface (see host/replay).
+ * Can't be combined with DEBUG_MODE in main.ino, both
+ * use the serial interface.
+ */
+//#define I2C_TRACE
+
+//***************************
+// Trace record payload
+//
+// [TIME (4)][ADDRESS|DIR (1)][STATUS (1)][DATA ...]
+//
+// TIME      millis() at the end of the transaction
+// ADDRESS   7-bit slave address, shifted left by one
+// DIR       bit 0: I2C_TRACE_WRITE or I2C_TRACE_READ
+// STATUS    return value of endTransmission() (write)
+//           or requestFrom() (read)
+//***************************
+#define I2C_TRACE_WRITE           0x00
+#define I2C_TRACE_READ            0x01
+#define I2C_TRACE_RECORD_HEADER   6
+#define I2C_TRACE_MAX_DATA        32
+
+#if defined(I2C_TRACE)
+
+//***************************
+// Methods
+//***************************
+class TraceWire : public SoftwareWire {
+  private:
+    uint8_t address;
+    uint8_t txLength;
+    uint8_t rxLength;
+    uint8_t rxIndex;
+    unsigned long transferEnd;      // micros()
+    uint8_t txBuffer[I2C_TRACE_MAX_DATA];
+    uint8_t rxBuffer[I2C_TRACE_MAX_DATA];
+    void record(uint8_t direction, uint8_t status, const uint8_t *data, uint8_t length);
+
+  public:
+    TraceWire(uint8_t pinSDA, uint8_t pinSCL);
+    void beginTransmission(uint8_t slaveAddress);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    uint8_t endTransmission(void);
+    uint8_t requestFrom(uint8_t slaveAddress, uint8_t quantity);
+    int available(void);
+    int read(void);
+    unsigned long getTransferEnd(void);
+};
+
+typedef TraceWire I2CWire;
+
+#else
+
+typedef SoftwareWire I2CWire;
+
+#endif
+
+#endif /* I2CTRACE_H_ */
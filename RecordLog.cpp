@@ -0,0 +1,175 @@
+/*
+ * RecordLog.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "RecordLog.h"
+#include "FRAM.h"
+#include "Telemetry.h"
+
+// Object of CRC calculation
+extern CRC crc;
+
+// Record ring in program FRAM, written with FRAM::write()
+// and read through a volatile pointer (see Burst.cpp).
+static const LogRecord buffer[LOG_MAX_RECORDS] = {{0, 0, 0, 0}};
+static const volatile LogRecord *records = buffer;
+
+static const unsigned long baudRates[LOG_BAUD_COUNT] = {9600, 19200, 38400, 57600, 115200};
+
+RecordLog::RecordLog()
+  : appendTime(0), exportNext(0), exportEnd(0), exporting(false) {
+}
+
+//*********************************************************
+// Count of records ever written, 0 if the state in FRAM
+// is invalid (the log starts again)
+//*********************************************************
+uint32_t RecordLog::total(void) {
+
+  const LogState *state = (const LogState *)FRAM_LOG_STATE;
+
+  if(state->magic != LOG_STATE_MAGIC ||
+     crc.Fast((const uint8_t *)state, sizeof(LogState) - 1) != state->crc)
+    return 0;
+  return ((uint32_t)state->totalHigh << 16) | state->totalLow;
+}
+
+// Index of the oldest record still stored
+uint32_t RecordLog::first(void) {
+
+  uint32_t count = total();
+  return count > LOG_MAX_RECORDS ? count - LOG_MAX_RECORDS : 0;
+}
+
+void RecordLog::saveTotal(uint32_t total) {
+
+  LogState state;
+
+  state.magic = LOG_STATE_MAGIC;
+  state.totalLow = total & 0xFFFF;
+  state.totalHigh = total >> 16;
+  state.reserved = 0;
+  state.crc = crc.Fast((const uint8_t *)&state, sizeof(state) - 1);
+  FRAM::write(FRAM_LOG_STATE, &state, sizeof(state));
+}
+
+//*********************************************************
+// Append a record, the oldest one is overwritten if the
+// log is full
+//
+// input:   co2           CO2 value in ppm
+//          tvoc          TVOC value in ppb
+//          temperature   temperature in 1/100 degree Celsius
+//          humidity      relative humidity in 1/100 percent
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void RecordLog::append(unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity) {
+
+  uint32_t count = total();
+  LogRecord record;
+
+  record.co2 = co2;
+  record.tvoc = tvoc;
+  record.temperature = temperature;
+  record.humidity = humidity;
+  // The record is complete before the count includes it
+  FRAM::write((uint16_t)(uintptr_t)&buffer[count % LOG_MAX_RECORDS], &record, sizeof(record));
+  saveTotal(count + 1);
+  appendTime = millis();
+}
+
+//*********************************************************
+// Start an export
+//
+// input:   first       index of the first record
+//          count       maximal count of records
+//
+// output:  none
+//
+// return:  false if an export is running
+//*********************************************************
+boolean RecordLog::startExport(uint32_t first, uint16_t count) {
+
+  if(exporting)
+    return false;
+  exportNext = first;
+  exportEnd = (count == 0xFFFF) ? 0xFFFFFFFFUL : first + count;
+  exporting = true;
+  return true;
+}
+
+boolean RecordLog::isExporting(void) {
+
+  return exporting;
+}
+
+//*********************************************************
+// Send the next export block
+// Records that were overwritten meanwhile are skipped,
+// the host sees the gap in INDEX. Records appended during
+// the export are included.
+//
+// input:   *telemetry  serial interface
+//          interval    minutes between two records
+//
+// output:  none
+//
+// return:  size of the sent frame in bytes, 0 if the
+//          export is over
+//*********************************************************
+unsigned int RecordLog::sendBlock(Telemetry *telemetry, uint8_t interval) {
+
+  if(!exporting)
+    return 0;
+
+  uint32_t count = total();
+  uint32_t oldest = count > LOG_MAX_RECORDS ? count - LOG_MAX_RECORDS : 0;
+  uint32_t end = exportEnd < count ? exportEnd : count;
+  uint8_t n = 0;
+
+  if(exportNext < oldest)
+    exportNext = oldest;
+  if(exportNext < end) {
+    // A block doesn't wrap around the end of the ring
+    uint16_t position = exportNext % LOG_MAX_RECORDS;
+    uint32_t left = end - exportNext;
+    n = LOG_BLOCK_RECORDS;
+    if(left < n)
+      n = left;
+    if(LOG_MAX_RECORDS - position < n)
+      n = LOG_MAX_RECORDS - position;
+  }
+  else
+    exporting = false;
+
+  uint8_t header[LOG_BLOCK_HEADER];
+  Telemetry::putUInt32(&header[0], exportNext);
+  Telemetry::putUInt32(&header[4], count);
+  Telemetry::putUInt32(&header[8], millis() - appendTime);
+  header[12] = interval;
+  telemetry->sendFrame(TELEMETRY_FRAME_EXPORT, header, LOG_BLOCK_HEADER,
+                       (const volatile uint8_t *)&records[exportNext % LOG_MAX_RECORDS], n * sizeof(LogRecord));
+  exportNext += n;
+
+  return LOG_BLOCK_HEADER + n * sizeof(LogRecord) + TELEMETRY_OVERHEAD;
+}
+
+//*********************************************************
+// Baud rate of an export
+//
+// input:   code        LOG_BAUD_xxx
+//
+// output:  none
+//
+// return:  baud rate, 0 if the code is unknown
+//*********************************************************
+unsigned long RecordLog::baudRate(uint8_t code) {
+
+  return code < LOG_BAUD_COUNT ? baudRates[code] : 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * RecordLog.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef RECORDLOG_H_
+#define RECORDLOG_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+class Telemetry;
+
+//***************************
+// Measurement log in program FRAM
+//
+// A ring of 128 records, one every logInterval minutes
+// of the configuration (Config.h): 32 hours at 15 min.
+// The count of records ever written is kept in the
+// information FRAM, record n is stored at n % 128.
+//***************************
+#define LOG_MAX_RECORDS           128
+#define LOG_STATE_MAGIC           0x10C5
+
+struct LogRecord {
+  uint16_t co2;             // ppm
+  uint16_t tvoc;            // ppb
+  int16_t temperature;      // 1/100 degree Celsius
+  uint16_t humidity;        // 1/100 percent
+};
+
+struct LogState {
+  uint16_t magic;
+  uint16_t totalLow;        // count of records ever written
+  uint16_t totalHigh;
+  uint8_t reserved;
+  uint8_t crc;              // CRC-8 over all bytes before
+};
+
+//***************************
+// Export (TELEMETRY_COMMAND_EXPORT)
+//
+// Command: [FIRST (4)][COUNT (2)][BAUD (1)]
+//
+// FIRST     index of the first record, older ones are
+//           skipped (resume with the next missing index)
+// COUNT     maximal count of records, 0xFFFF = all
+// BAUD      LOG_BAUD_xxx, the device switches 20 ms after
+//           the command and back after the last block
+//
+// Block payload (TELEMETRY_FRAME_EXPORT):
+//
+// [INDEX (4)][TOTAL (4)][AGE (4)][INTERVAL (1)][RECORD (8) ...]
+//
+// INDEX     index of the first record in this block
+// TOTAL     count of records ever written
+// AGE       ms since the newest record was written (since
+//           the reset if there's none since then)
+// INTERVAL  minutes between two records
+// RECORD    LogRecord, little-endian as stored in FRAM
+//
+// The records are sent straight from FRAM, protected by
+// the frame CRC. A block without records ends the export.
+//***************************
+#define LOG_BLOCK_HEADER          13
+#define LOG_BLOCK_RECORDS         8         // 77 bytes, TELEMETRY_MAX_EXPORT_PAYLOAD
+#define LOG_SWITCH_TIME           20        // ms for the host to change the baud rate
+
+enum {
+  LOG_BAUD_9600, LOG_BAUD_19200, LOG_BAUD_38400, LOG_BAUD_57600, LOG_BAUD_115200, LOG_BAUD_COUNT
+};
+
+//***************************
+// Methods
+//***************************
+class RecordLog {
+  private:
+    unsigned long appendTime;   // millis() of the newest record
+    uint32_t exportNext;
+    uint32_t exportEnd;
+    boolean exporting;
+    void saveTotal(uint32_t total);
+
+  public:
+    RecordLog();
+    void append(unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity);
+    uint32_t total(void);
+    uint32_t first(void);
+    boolean startExport(uint32_t first, uint16_t count);
+    boolean isExporting(void);
+    unsigned int sendBlock(Telemetry *telemetry, uint8_t interval);
+    static unsigned long baudRate(uint8_t code);
+};
+
+#endif /* RECORDLOG_H_ */
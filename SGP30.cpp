@@ -11,6 +11,26 @@
 // Object of CRC calculation
 extern CRC crc;
 
+//***************************
+// Command table, indexed by SGP30_CMD_xxx
+// Durations are the maximal values of the datasheet.
+//***************************
+static const SGP30Command commands[SGP30_CMD_COUNT] = {
+  // code                           tx  rx  ms   heat
+  {SGP30_INIT_AIR_QUALITY,          0,  0,  10,  1},
+  {SGP30_MEASURE_AIR_QUALITY,       0,  2,  12,  1},
+  {SGP30_GET_BASELINE,              0,  2,  10,  0},
+  {SGP30_SET_BASELINE,              2,  0,  10,  0},
+  {SGP30_MEASURE_TEST,              0,  1,  220, 1},
+  {SGP30_GET_FEATURE_SET_VERISON,   0,  1,  2,   0},
+  {SGP30_MEASURE_SIGNALS,           0,  2,  25,  1},
+  {SGP30_GET_SERIAL_ID,             0,  3,  1,   0},     // 0.5 ms
+};
+
+SGP30::SGP30()
+  : pending(SGP30_CMD_NONE), readyTime(0), heaterOn(false), heaterStart(0), heaterTime(0) {
+}
+
 //*********************************************************
 // Perform a checksum test for all receveid data
 //
@@ -23,161 +43,192 @@ extern CRC crc;
 //*********************************************************
 bool SGP30::checksumCalculation(uint8_t *data, uint8_t byteCtr) {
 
-	uint8_t i = 0;
-	uint8_t k = 0;
-
-	uint8_t tmpData[2] = {0};
-	boolean crcResult[3] = {true, true, true};
-
-	for(i=0; i<byteCtr; i=i+3) {
-		tmpData[0] = data[i];
-		tmpData[1] = data[i+1];
-		if(crc.Fast(tmpData, 2) == data[i+2])
-			crcResult[k] = true;
-		else crcResult[k] = false;
-		k++;
+	for(uint8_t i = 0; i < byteCtr; i = i + 3) {
+		if(crc.Fast(&data[i], 2) != data[i+2])
+			return false;
 	}
-
-	if(crcResult[0] == true && crcResult[1] == true && crcResult[2] == true)
-		return true;
-	else
-		return false;
+	return true;
 }
 
 //*********************************************************
-// Read out Serial ID of device
+// Descriptor of a command
 //
-// input:	  none
+// input:	  command			SGP30_CMD_xxx
 //
 // output:  none
 //
-// return:	serial ID (32 bits, returned in 64-bit value)
+// return:	entry of the command table
 //*********************************************************
-unsigned long long SGP30::getSerialID(void) {
+const SGP30Command *SGP30::command(uint8_t command) {
 
-	uint8_t id_rawData[9] = {0};
-	uint8_t cmd[2] = {SGP30_GET_SERIAL_ID >> 8, SGP30_GET_SERIAL_ID & 0x00FF};
-
-	// Get 9 bytes raw data of ID with checksums
-	Wire.beginTransmission(SGP30_ADDRESS);
-	Wire.write(cmd, 2);
-  Wire.requestFrom(SGP30_ADDRESS, 9);
-  uint8_t i = 0;
-  while(Wire.available()) {
-    id_rawData[i++] = Wire.read();
-  }
-  Wire.endTransmission();
-
-	unsigned int id1 = id_rawData[8] << 8 | id_rawData[7];
-	unsigned int id2 = id_rawData[5] << 8 | id_rawData[4];
-	unsigned int id3 = id_rawData[2] << 8 | id_rawData[1];
-
-	boolean dataValid = checksumCalculation(id_rawData, 9);
-
-	if(!dataValid) {
-		Serial.println("ERROR SGP30: Unexpected checksum value");
-	}
-	else return ((unsigned long long)id1 << 32) | ((unsigned long long)id2 << 16) | id3;
+	return &commands[command];
 }
 
 //*********************************************************
-// Initialize measurement
-// Needs to be called once after every power-up or reset!
+// Send a command with its parameters
+// The sensor is busy until the returned time is over,
+// then finish() fetches the response.
 //
-// input:	  none
+// input:	  command			SGP30_CMD_xxx
+//			    *parameters	txWords parameter words
 //
 // output:  none
 //
-// return:	none
+// return:	time in ms until finish() can be called
+//          (execution time + 1 ms resolution of millis())
 //*********************************************************
-void SGP30::initializeMeasurement(void) {
+unsigned int SGP30::start(uint8_t command, const uint16_t *parameters) {
+
+	const SGP30Command *c = &commands[command];
+	uint8_t transmitData[2 + 3 * SGP30_MAX_WORDS];
+	uint8_t length = 2;
 
-	uint8_t transmitData[2] = {(SGP30_INIT_AIR_QUALITY>>8),
-						   (SGP30_INIT_AIR_QUALITY&0xFF)};
+	transmitData[0] = c->code >> 8;
+	transmitData[1] = c->code & 0x00FF;
+	for(uint8_t i = 0; i < c->txWords; i++) {
+		transmitData[length] = parameters[i] >> 8;
+		transmitData[length+1] = parameters[i] & 0x00FF;
+		transmitData[length+2] = crc.Fast(&transmitData[length], 2);
+		length += 3;
+	}
 
-	// Transmit command to initialize measurement
 	Wire.beginTransmission(SGP30_ADDRESS);
-  Wire.write(transmitData, 2);
+  Wire.write(transmitData, length);
   Wire.endTransmission();
+
+	if(c->heater && !heaterOn) {
+		heaterOn = true;
+		heaterStart = millis();
+	}
+	pending = command;
+	readyTime = millis() + c->duration + 1;
+	return c->duration + 1;
 }
 
 //*********************************************************
-// Perform measurement and get data
-// Should be  called every second to ensure proper
-// operation of internal dynamic correction algorithms
+// Fetch the response of the command sent by start()
+// Waits for the rest of the execution time if it's
+// called too early.
 //
-// input:   none
+// input:	  none
 //
-// output:  *CO2ppm			CO2 value
-//			    *TVOCppb		TVOC value
+// output:  *words			rxWords response words
 //
-// return:	none
+// return:	boolean			false if crc is incorrect or no
+//                      command was started
 //*********************************************************
-void SGP30::getMeasurementData(unsigned int *CO2ppm, unsigned int *TVOCppb) {
+boolean SGP30::finish(uint16_t *words) {
 
-	uint8_t receiveData[6] = {0};
-	uint8_t cmd[2] = {SGP30_MEASURE_AIR_QUALITY >> 8, SGP30_MEASURE_AIR_QUALITY & 0x00FF};
+	if(pending == SGP30_CMD_NONE)
+		return false;
 
-	// Fetch measurement data
-	Wire.beginTransmission(SGP30_ADDRESS);
-  Wire.write(cmd, 2);
-	Wire.requestFrom(SGP30_ADDRESS, 6);
+	unsigned long wait = dueIn();
+	if(wait > 0)
+		delay(wait);
+
+	const SGP30Command *c = &commands[pending];
+	pending = SGP30_CMD_NONE;
+	if(c->rxWords == 0)
+		return true;
+
+	uint8_t receiveData[3 * SGP30_MAX_WORDS] = {0};
+	uint8_t length = 3 * c->rxWords;
+
+	Wire.requestFrom(SGP30_ADDRESS, length);
   uint8_t i = 0;
-  while(Wire.available()) {
+  while(Wire.available() && i < length) {
     receiveData[i++] = Wire.read();
   }
-	Wire.endTransmission();
-
-	// Convert raw data
-	*CO2ppm = (unsigned int)receiveData[0]<<8 | receiveData[1];
-	*TVOCppb = (unsigned int)receiveData[3]<<8 | receiveData[4];
 
-	boolean dataValid = checksumCalculation(receiveData, 6);
+	for(uint8_t k = 0; k < c->rxWords; k++) {
+		words[k] = (uint16_t)receiveData[3*k] << 8 | receiveData[3*k+1];
+	}
 
-	if(dataValid != true) {
+	if(i != length || !checksumCalculation(receiveData, length)) {
 		Serial.println("ERROR SGP30: Unexpected checksum value");
+		return false;
 	}
+	return true;
 }
 
 //*********************************************************
-// Do a self-test of the sensor
-// Sensor should respond 0xD400 over I2C
+// Execute a command and wait for its response
+//
+// input:	  command			SGP30_CMD_xxx
+//			    *parameters	txWords parameter words
+//
+// output:  *words			rxWords response words
+//
+// return:	boolean			false if crc is incorrect
+//*********************************************************
+boolean SGP30::execute(uint8_t command, uint16_t *words, const uint16_t *parameters) {
+
+	start(command, parameters);
+	return finish(words);
+}
+
+boolean SGP30::isBusy(void) {
+
+	return pending != SGP30_CMD_NONE;
+}
+
+uint8_t SGP30::pendingCommand(void) {
+
+	return pending;
+}
+
+//*********************************************************
+// Time until the response of the running command is due
 //
 // input:	  none
 //
 // output:  none
 //
-// return:	1 - initialised correctly
-//          0 - initialised incorrectly
+// return:	time in ms, 0 if due or no command is running
 //*********************************************************
-boolean SGP30::isInitialised(void) {
+unsigned long SGP30::dueIn(void) {
 
-	uint8_t receiveData[3] = {0};
-	uint8_t cmd[2] = {SGP30_MEASURE_TEST >> 8, SGP30_MEASURE_TEST & 0x00FF};
-	unsigned int checkData = 0;
+	if(pending == SGP30_CMD_NONE)
+		return 0;
+	long remaining = (long)(readyTime - millis());
+	return remaining > 0 ? remaining : 0;
+}
 
-	// Send command for self-test
-	Wire.beginTransmission(SGP30_ADDRESS);
-  Wire.write(cmd, 2);
-	Wire.requestFrom(SGP30_ADDRESS, 3);
-  uint8_t i = 0;
-  while(Wire.available()) {
-    receiveData[i++] = Wire.read();
-  }
-  Wire.endTransmission();
+//*********************************************************
+// Time the hot plate was heated (energy accounting)
+// The measurement commands switch it on, only a reset
+// switches it off again.
+//
+// input:	  none
+//
+// output:  none
+//
+// return:	time in ms
+//*********************************************************
+unsigned long SGP30::getHeaterTime(void) {
 
-	boolean dataValid = checksumCalculation(receiveData, 3);
+	if(heaterOn)
+		return heaterTime + (millis() - heaterStart);
+	return heaterTime;
+}
 
-	if(dataValid == true) {
-		// Validate received data pattern (should be 0xD400)
-		checkData = ((unsigned int)receiveData[0] << 8) | receiveData[1];
-	}
+//*********************************************************
+// Read out Serial ID of device
+//
+// input:	  none
+//
+// output:  none
+//
+// return:	serial ID (48 bits, returned in 64-bit value),
+//          0 if crc is incorrect
+//*********************************************************
+unsigned long long SGP30::getSerialID(void) {
 
-	if(checkData != 0xD400) {
-    Serial.println("ERROR SGP30: Sensor is not initialised correctly");
-		return false;
-	}
-	else return true;
+	uint16_t id[3] = {0};
+
+	if(!execute(SGP30_CMD_GET_SERIAL_ID, id))
+		return 0;
+	return ((unsigned long long)id[0] << 32) | ((unsigned long long)id[1] << 16) | id[2];
 }
 
 //*********************************************************
@@ -200,4 +251,11 @@ void SGP30::softReset(void) {
 	Wire.beginTransmission(I2C_GENERAL_CALL_ADDRESS);
   Wire.write(transmitData, 2);
   Wire.endTransmission();
+
+	// A running command is aborted, the hot plate is off
+	pending = SGP30_CMD_NONE;
+	if(heaterOn) {
+		heaterTime += millis() - heaterStart;
+		heaterOn = false;
+	}
 }
@@ -11,8 +11,8 @@
 #include "crc.h"
 #include <stdint.h>
 
-#include "I2C_SoftwareLibrary.h"
-extern SoftwareWire Wire;
+#include "I2CBus.h"
+extern I2CBus Wire;
 
 #define SGP30_ADDRESS		0x58
 
@@ -26,7 +26,7 @@ extern SoftwareWire Wire;
 #define SGP30_SET_BASELINE				    0x201E
 #define SGP30_MEASURE_TEST				    0x2032
 #define SGP30_GET_FEATURE_SET_VERISON	0x202F
-#define SGP30_MEASURE_SIGNALS			    0x2050		// Requires a reference gas concentration
+#define SGP30_MEASURE_SIGNALS			    0x2050		// Raw H2 and ethanol signals
 
 #define SGP30_GET_SERIAL_ID				    0x3682
 
@@ -37,18 +37,62 @@ extern SoftwareWire Wire;
 #define SGP30_RESET_SCND_BYTE			    0x0006
 #define SGP30_RESET_COMMAND				    0x0006
 
+//***************************
+// Command table (see SGP30.cpp)
+// Index into the table, one entry per command with
+// opcode, parameter/response word counts and the
+// maximal execution time of the datasheet.
+//***************************
+enum {
+  SGP30_CMD_INIT_AIR_QUALITY,
+  SGP30_CMD_MEASURE_AIR_QUALITY,
+  SGP30_CMD_GET_BASELINE,
+  SGP30_CMD_SET_BASELINE,
+  SGP30_CMD_MEASURE_TEST,
+  SGP30_CMD_GET_FEATURE_SET_VERSION,
+  SGP30_CMD_MEASURE_SIGNALS,
+  SGP30_CMD_GET_SERIAL_ID,
+  SGP30_CMD_COUNT,
+  SGP30_CMD_NONE = 0xFF
+};
+
+struct SGP30Command {
+  uint16_t code;
+  uint8_t txWords;      // parameter words (with CRC each)
+  uint8_t rxWords;      // response words (with CRC each)
+  uint8_t duration;     // maximal execution time in ms
+  uint8_t heater;       // switches the hot plate on (until a reset)
+};
+
+#define SGP30_MAX_WORDS               3
+#define SGP30_SELFTEST_OK             0xD400
+
+#define SGP30_RESET_TIME				      1		    // power-up 0.6 ms
+#define SGP30_WARMUP_TIME				      15000		// fixed 400 ppm/ 0 ppb after init
+
 //***************************
 // Methods
 //***************************
 class SGP30{
   private:
+    uint8_t pending;                // command waiting for its response
+    unsigned long readyTime;        // millis() when the response is due
+    boolean heaterOn;
+    unsigned long heaterStart;      // millis()
+    unsigned long heaterTime;       // ms, without the current period
     bool checksumCalculation(uint8_t *data, uint8_t byteCtr);
     
   public:
+    SGP30();
+    static const SGP30Command *command(uint8_t command);
+    unsigned int start(uint8_t command, const uint16_t *parameters = 0);
+    boolean finish(uint16_t *words);
+    boolean execute(uint8_t command, uint16_t *words, const uint16_t *parameters = 0);
+    boolean isBusy(void);
+    uint8_t pendingCommand(void);
+    unsigned long dueIn(void);
+    unsigned long getHeaterTime(void);
     unsigned long long getSerialID(void);
-    void initializeMeasurement(void);
-    void getMeasurementData(unsigned int *CO2ppm, unsigned int *TVOCppb);
-    boolean isInitialised(void);
     void softReset(void);
 };
 
@@ -7,6 +7,19 @@
 
 #include "SHT21.h"
 
+// maximal conversion times in ms per resolution (datasheet),
+// index: user register bit 7 and bit 0
+static const uint8_t rhTimes[4] = {SHT21_RH_MEAS_TIME, 4, 9, 15};
+static const uint8_t tTimes[4] = {SHT21_T_MEAS_TIME, 22, 43, 11};
+
+static uint8_t timeIndex(uint8_t resolution) {
+
+  return ((resolution >> 6) & 0x02) | (resolution & 0x01);
+}
+
+SHT21::SHT21() : resolution(SHT21_RESOLUTION_12_14), conversionTime(0) {
+}
+
 //**********************************************************************************
 // Calculates checksum for n bytes of data and compares it with expected checksum
 //
@@ -44,41 +57,76 @@ boolean SHT21::checkCRC(uint8_t *data, uint8_t numberOfBytes, uint8_t checksum){
 }
 
 //**********************************************************************************
-// Performs a measurement of humidity or temperature. This function automatically
-// polls result every 10 ms until measurement is ready.
+// Performs a measurement of humidity or temperature. Blocks for the conversion
+// time of the sensor.
 //
 // input: 		MeasureType     Can be 'HUMIDITY' (01h) or 'TEMP' (02h)
 //
 // output:    none
 //     		
-// return: 		result_value    Humidity/ temperature as float value
+// return: 		result_value    Humidity/ temperature as float value, 0 on error
 //**********************************************************************************
 float SHT21::readSensor(uint8_t MeasureType){
 
-	uint8_t received_data[3];
+	unsigned int conversion_time = startMeasurement(MeasureType);
+	float value;
+
+	if(conversion_time == 0)
+	  return 0;
+	delay(conversion_time);
+	if(!readMeasurement(MeasureType, &value))
+	  return 0;
+	return value;
+}
+
+//**********************************************************************************
+// Triggers a measurement of humidity or temperature (no hold master). The result
+// is fetched with readMeasurement() after the returned conversion time.
+//
+// input: 		MeasureType     Can be 'HUMIDITY' (01h) or 'TEMP' (02h)
+//
+// output:    none
+//
+// return: 		conversion time in ms, 0 if MeasureType is invalid
+//**********************************************************************************
+unsigned int SHT21::startMeasurement(uint8_t MeasureType){
+
 	uint8_t command;
-	unsigned int data;
-  
+	unsigned int conversion_time;
+
 	// select measure type and set command
 	switch (MeasureType){
 		case HUMIDITY:
-			command = SHT21_TRIGGER_RH_MEAS; break;
+			command = SHT21_TRIGGER_RH_MEAS; conversion_time = rhTimes[timeIndex(resolution)]; break;
 		case TEMP:
-			command = SHT21_TRIGGER_T_MEAS; break;
-		default: command = SHT21_RESET;	// reset if MeasureType is invalid
+			command = SHT21_TRIGGER_T_MEAS; conversion_time = tTimes[timeIndex(resolution)]; break;
+		default:
+			Serial.println("ERROR SHT21: Unexpected parameter (MeasureType)");
+			return 0;
 	}
 	// transmit command
   Wire.beginTransmission(SHT21_ADDRESS);
   Wire.write(command);
   Wire.endTransmission();
 
-	// wait for measurement time depending on measure type
-	if(MeasureType == HUMIDITY)delay(35);
-	else if(MeasureType == TEMP)delay(90);
-	else {
-    Serial.println("ERROR SHT21: Unexpected parameter (MeasureType)");
-	  return 0;
-	}
+	conversionTime += conversion_time;
+	return conversion_time;
+}
+
+//**********************************************************************************
+// Reads the result of a measurement started with startMeasurement()
+//
+// input: 		MeasureType     Can be 'HUMIDITY' (01h) or 'TEMP' (02h)
+//
+// output:    *value          Humidity/ temperature, unchanged on error
+//
+// return: 		0 = checksum does not match or MeasureType is invalid
+// 				    1 = value is valid
+//**********************************************************************************
+boolean SHT21::readMeasurement(uint8_t MeasureType, float *value){
+
+	uint8_t received_data[3];
+	unsigned int data;
 
 	// read 2 data bytes and 1 checksum byte
 	// combine data to one 16-Bit raw value
@@ -91,19 +139,20 @@ float SHT21::readSensor(uint8_t MeasureType){
 
 	// checksum error detection
 	uint8_t crc_data[2] = {received_data[0], received_data[1]};
-	if(checkCRC(crc_data, 2, received_data[2]) == true);
-	else Serial.println("ERROR SHT21: Unexpected checksum value");
+	if(!checkCRC(crc_data, 2, received_data[2]))
+	  return false;
 
 	// calculate humidity or temperature
 	// in dependence of measure type
 	if(MeasureType == HUMIDITY)
-		return (-6.0 + 125.0/65536 * (float)data);
+		*value = -6.0 + 125.0/65536 * (float)data;
 	else if(MeasureType == TEMP)
-		return (-46.85 + 175.72/65536 * (float)data);
+		*value = -46.85 + 175.72/65536 * (float)data;
 	else {
     Serial.println("ERROR SHT21: Unexpected measured value");
-	  return 0;
+	  return false;
 	}
+	return true;
 }
 
 //**********************************************************************************
@@ -120,10 +169,10 @@ uint8_t SHT21::readUserRegister(void){
   // send command to read user register
   Wire.beginTransmission(SHT21_ADDRESS);
   Wire.write(SHT21_READ_USER_REG);
+  Wire.endTransmission();
   // read register data
   Wire.requestFrom(SHT21_ADDRESS, 1);
   uint8_t register_value = Wire.read();
-  Wire.endTransmission();
 
 	return register_value;
 }
@@ -147,25 +196,81 @@ void SHT21::writeUserRegister(uint8_t register_value){
   Wire.endTransmission();
 }
 
+//**********************************************************************************
+// Sets the measurement resolution, the other bits of the user register are kept
+// (reserved bits must not be changed). Lower resolutions shorten the conversion
+// times returned by startMeasurement().
+//
+// input: 	value           SHT21_RESOLUTION_xxx
+//
+// output:  none
+//
+// return: 	none
+//**********************************************************************************
+void SHT21::setResolution(uint8_t value){
+
+  value &= SHT21_RESOLUTION_MASK;
+  writeUserRegister((readUserRegister() & ~SHT21_RESOLUTION_MASK) | value);
+  resolution = value;
+}
+
+uint8_t SHT21::getResolution(void){
+
+  return resolution;
+}
+
 //******************************************
-// Performs a soft reset for SHT21
+// Time the sensor was converting (energy
+// accounting), maximal conversion times
 //
 // input:   none
 //
 // output:  none
 //
-// return:  none
+// return:  sum of all conversions in ms
 //******************************************
-void SHT21::softReset(void){
+unsigned long SHT21::getConversionTime(void){
+
+  return conversionTime;
+}
+
+//******************************************
+// Sends the soft reset command without waiting
+// Addressed to the SHT21 only, other devices on
+// the bus keep running.
+//
+// input:   none
+//
+// output:  none
+//
+// return:  time in ms until the sensor is ready
+//******************************************
+unsigned int SHT21::startReset(void){
 
   uint8_t transmit_data = SHT21_RESET;
-  
+
 	// send reset command
   Wire.beginTransmission(SHT21_ADDRESS);
   Wire.write(&transmit_data, 1);
   Wire.endTransmission();
 
-	delay(15);	// delay for start-up
+  // the reset restores the default resolution
+  resolution = SHT21_RESOLUTION_12_14;
+  return SHT21_RESET_TIME;
+}
+
+//******************************************
+// Performs a soft reset for SHT21
+//
+// input:   none
+//
+// output:  none
+//
+// return:  none
+//******************************************
+void SHT21::softReset(void){
+
+	delay(startReset());	// delay for start-up
 
   // re-initialize I2C
   Wire.begin();
@@ -11,8 +11,8 @@
 #include "Energia.h"
 #include <stdint.h>
 
-#include "I2C_SoftwareLibrary.h"
-extern SoftwareWire Wire;
+#include "I2CBus.h"
+extern I2CBus Wire;
 
 // slave address
 #define SHT21_ADDRESS					    0x40
@@ -24,6 +24,18 @@ extern SoftwareWire Wire;
 #define SHT21_WRITE_USER_REG			0xE6
 #define SHT21_RESET						    0xFE
 
+// maximal conversion times in ms (datasheet, RH 12 bit, T 14 bit)
+#define SHT21_RH_MEAS_TIME				29
+#define SHT21_T_MEAS_TIME				  85
+#define SHT21_RESET_TIME				  15
+
+// resolution, bits 7 and 0 of the user register
+#define SHT21_RESOLUTION_MASK     0x81
+#define SHT21_RESOLUTION_12_14    0x00    // RH 12 bit, T 14 bit (default)
+#define SHT21_RESOLUTION_8_12     0x01    // RH 8 bit, T 12 bit
+#define SHT21_RESOLUTION_10_13    0x80    // RH 10 bit, T 13 bit
+#define SHT21_RESOLUTION_11_11    0x81    // RH 11 bit, T 11 bit
+
 // measure modes
 enum {
 	HUMIDITY = 0x01, TEMP = 0x02
@@ -31,12 +43,21 @@ enum {
 
 class SHT21 {
   private:  
+    uint8_t resolution;
+    unsigned long conversionTime;   // ms of all started conversions
     uint8_t readUserRegister(void);
     void writeUserRegister(uint8_t register_value);
     
   public:
+    SHT21();
     float readSensor(uint8_t MeasureType);
+    unsigned int startMeasurement(uint8_t MeasureType);
+    boolean readMeasurement(uint8_t MeasureType, float *value);
     boolean checkCRC(uint8_t *data, uint8_t numberOfBytes, uint8_t checksum);
+    unsigned int startReset(void);
+    void setResolution(uint8_t value);
+    uint8_t getResolution(void);
+    unsigned long getConversionTime(void);
     void softReset(void);
 };
 
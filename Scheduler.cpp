@@ -0,0 +1,127 @@
+/*
+ * Scheduler.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Scheduler.h"
+
+Scheduler::Scheduler() {
+
+  for(uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    tasks[i].function = 0;
+    tasks[i].due = 0;
+    tasks[i].pending = false;
+  }
+}
+
+//*********************************************************
+// Assign the function of a task
+//
+// input:   task        task number (< SCHEDULER_MAX_TASKS)
+//          function    called when the task is due
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Scheduler::setTask(uint8_t task, TaskFunction function) {
+
+  tasks[task].function = function;
+  tasks[task].pending = false;
+}
+
+//*********************************************************
+// Run a task once after a delay
+// A pending run of the task is replaced.
+//
+// input:   task        task number
+//          delayMs     delay in ms, 0 = next call of run()
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Scheduler::schedule(uint8_t task, unsigned long delayMs) {
+
+  scheduleAt(task, millis() + delayMs);
+}
+
+//*********************************************************
+// Run a task once at a fixed time
+// Keeps periodic tasks free of drift.
+//
+// input:   task        task number
+//          time        value of millis()
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Scheduler::scheduleAt(uint8_t task, unsigned long time) {
+
+  tasks[task].due = time;
+  tasks[task].pending = true;
+}
+
+void Scheduler::cancel(uint8_t task) {
+
+  tasks[task].pending = false;
+}
+
+boolean Scheduler::isScheduled(uint8_t task) {
+
+  return tasks[task].pending;
+}
+
+//*********************************************************
+// Time until a task is due
+//
+// input:   task        task number
+//
+// output:  none
+//
+// return:  time in ms, 0 if already due,
+//          SCHEDULER_NEVER if not scheduled
+//*********************************************************
+unsigned long Scheduler::dueIn(uint8_t task) {
+
+  if(!tasks[task].pending)
+    return SCHEDULER_NEVER;
+  long remaining = (long)(tasks[task].due - millis());
+  return remaining > 0 ? remaining : 0;
+}
+
+//*********************************************************
+// Run all due tasks
+//
+// input:   none
+//
+// output:  none
+//
+// return:  time in ms until the next task is due
+//          (0 = a task is already due again)
+//*********************************************************
+unsigned long Scheduler::run(void) {
+
+  for(uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    if(tasks[i].pending && (long)(millis() - tasks[i].due) >= 0) {
+      tasks[i].pending = false;
+      tasks[i].function();
+    }
+  }
+
+  unsigned long now = millis();
+  unsigned long wait = SCHEDULER_MAX_SLEEP;
+  for(uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    if(!tasks[i].pending)
+      continue;
+    long remaining = (long)(tasks[i].due - now);
+    if(remaining <= 0)
+      return 0;
+    if((unsigned long)remaining < wait)
+      wait = remaining;
+  }
+  return wait;
+}
@@ -0,0 +1,46 @@
+/*
+ * Scheduler.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS     10
+#define SCHEDULER_MAX_SLEEP     1000      // ms, if no task is pending
+#define SCHEDULER_NEVER         0xFFFFFFFFUL
+
+typedef void (*TaskFunction)(void);
+
+//***************************
+// Cooperative one-shot timers
+// A task runs once when it is due; periodic tasks
+// schedule themselves again. Task functions must not
+// block, longer operations are split into states.
+//***************************
+class Scheduler {
+  private:
+    struct Task {
+      TaskFunction function;
+      unsigned long due;
+      boolean pending;
+    };
+    Task tasks[SCHEDULER_MAX_TASKS];
+
+  public:
+    Scheduler();
+    void setTask(uint8_t task, TaskFunction function);
+    void schedule(uint8_t task, unsigned long delayMs);
+    void scheduleAt(uint8_t task, unsigned long time);
+    void cancel(uint8_t task);
+    boolean isScheduled(uint8_t task);
+    unsigned long dueIn(uint8_t task);
+    unsigned long run(void);
+};
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,248 @@
+/*
+ * Telemetry.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Energia.h"
+#include "Telemetry.h"
+
+// Object of CRC calculation
+extern CRC crc;
+
+Telemetry::Telemetry() : deviceID(0), sequence(0), receivedLength(0) {
+}
+
+//*********************************************************
+// Set the device ID sent with every reading
+//
+// input:   device      device ID
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Telemetry::begin(uint32_t device) {
+
+  deviceID = device;
+  sequence = 0;
+}
+
+//*********************************************************
+// Build a complete frame (sync, header, payload, crc)
+// This function has no hardware dependencies, so host
+// tools use it to produce bit-identical frames.
+//
+// input:   type        frame type (TELEMETRY_FRAME_xxx)
+//          *payload    payload bytes
+//          length      count of payload bytes
+//
+// output:  *frame      encoded frame, at least
+//                      length + TELEMETRY_OVERHEAD bytes
+//
+// return:  size of encoded frame, 0 if payload too long
+//*********************************************************
+uint8_t Telemetry::encodeFrame(uint8_t *frame, uint8_t type, const uint8_t *payload, uint8_t length) {
+
+  if(length > TELEMETRY_MAX_PAYLOAD)
+    return 0;
+
+  frame[0] = TELEMETRY_SYNC;
+  frame[1] = type;
+  frame[2] = length;
+  for(uint8_t i = 0; i < length; i++) {
+    frame[TELEMETRY_HEADER_SIZE + i] = payload[i];
+  }
+  frame[TELEMETRY_HEADER_SIZE + length] = crc.Fast(&frame[1], length + 2);
+
+  return length + TELEMETRY_OVERHEAD;
+}
+
+//*********************************************************
+// Build a complete reading frame
+// Used by the firmware and by the host load generator.
+//
+// input:   device        device ID
+//          sequence      sequence number of the reading
+//          time          millis() of the measurement
+//          co2           CO2 value in ppm
+//          tvoc          TVOC value in ppb
+//          temperature   temperature in 1/100 degree Celsius
+//          humidity      relative humidity in 1/100 percent
+//
+// output:  *frame        encoded frame, at least
+//                        TELEMETRY_READING_SIZE + TELEMETRY_OVERHEAD bytes
+//
+// return:  size of encoded frame
+//*********************************************************
+uint8_t Telemetry::encodeReading(uint8_t *frame, uint32_t device, uint16_t sequence, uint32_t time,
+                                 unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity) {
+
+  uint8_t payload[TELEMETRY_READING_SIZE];
+
+  putUInt32(&payload[0], device);
+  putUInt16(&payload[4], sequence);
+  putUInt32(&payload[6], time);
+  putUInt16(&payload[10], co2);
+  putUInt16(&payload[12], tvoc);
+  putUInt16(&payload[14], (uint16_t)temperature);
+  putUInt16(&payload[16], humidity);
+
+  return encodeFrame(frame, TELEMETRY_FRAME_READING, payload, TELEMETRY_READING_SIZE);
+}
+
+//*********************************************************
+// Convert a float value to 1/100 units, rounded
+//
+// input:   value       temperature or humidity
+//
+// output:  none
+//
+// return:  value * 100
+//*********************************************************
+int Telemetry::toCentiUnits(float value) {
+
+  if(value < 0)
+    return (int)(value * 100 - 0.5);
+  else
+    return (int)(value * 100 + 0.5);
+}
+
+//*********************************************************
+// Store 16/32-bit values little-endian into a payload
+//
+// input:   value       value to store
+//
+// output:  *buffer     destination (2 or 4 bytes)
+//
+// return:  none
+//*********************************************************
+void Telemetry::putUInt16(uint8_t *buffer, uint16_t value) {
+
+  buffer[0] = value & 0xFF;
+  buffer[1] = value >> 8;
+}
+
+void Telemetry::putUInt32(uint8_t *buffer, uint32_t value) {
+
+  putUInt16(buffer, value & 0xFFFF);
+  putUInt16(buffer + 2, value >> 16);
+}
+
+//*********************************************************
+// Encode a frame and send it over the serial interface
+//
+// input:   type        frame type (TELEMETRY_FRAME_xxx)
+//          *payload    payload bytes
+//          length      count of payload bytes
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Telemetry::sendFrame(uint8_t type, const uint8_t *payload, uint8_t length) {
+
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  uint8_t frameLength = encodeFrame(frame, type, payload, length);
+
+  if(frameLength > 0)
+    Serial.write(frame, frameLength);
+}
+
+//*********************************************************
+// Send a frame without building it in RAM
+// The data is written byte by byte from where it is, e.g.
+// records in FRAM. Export blocks may be longer than
+// TELEMETRY_MAX_PAYLOAD (TELEMETRY_MAX_EXPORT_PAYLOAD).
+//
+// input:   type          frame type (TELEMETRY_FRAME_xxx)
+//          *header       first payload bytes
+//          headerLength  count of header bytes
+//          *data         rest of the payload
+//          dataLength    count of data bytes
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Telemetry::sendFrame(uint8_t type, const uint8_t *header, uint8_t headerLength,
+                          const volatile uint8_t *data, uint8_t dataLength) {
+
+  uint8_t start[TELEMETRY_HEADER_SIZE] = {TELEMETRY_SYNC, type, (uint8_t)(headerLength + dataLength)};
+  crcType checksum = crc.Fast(&start[1], 2);
+
+  Serial.write(start, TELEMETRY_HEADER_SIZE);
+  checksum = crc.Fast(header, headerLength, checksum);
+  Serial.write(header, headerLength);
+  for(uint8_t i = 0; i < dataLength; i++) {
+    uint8_t value = data[i];
+    checksum = crc.Fast(&value, 1, checksum);
+    Serial.write(value);
+  }
+  Serial.write((uint8_t)checksum);
+}
+
+//*********************************************************
+// Send the current measurement values as reading frame
+//
+// input:   co2           CO2 value in ppm
+//          tvoc          TVOC value in ppb
+//          temperature   temperature in degree Celsius
+//          humidity      relative humidity in percent
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Telemetry::sendReading(unsigned int co2, unsigned int tvoc, float temperature, float humidity) {
+
+  uint8_t frame[TELEMETRY_READING_SIZE + TELEMETRY_OVERHEAD];
+  uint8_t frameLength = encodeReading(frame, deviceID, sequence++, millis(), co2, tvoc,
+                                      toCentiUnits(temperature), toCentiUnits(humidity));
+
+  Serial.write(frame, frameLength);
+}
+
+//*********************************************************
+// Collect received bytes into a frame
+// Doesn't block, call it regularly. Bytes before a sync
+// byte and frames with a wrong CRC are dropped.
+//
+// input:   none
+//
+// output:  *type       frame type (TELEMETRY_FRAME_xxx)
+//          *payload    payload, TELEMETRY_MAX_PAYLOAD bytes
+//          *length     count of payload bytes
+//
+// return:  true if a complete frame was received
+//*********************************************************
+bool Telemetry::receiveFrame(uint8_t *type, uint8_t *payload, uint8_t *length) {
+
+  while(Serial.available() > 0) {
+    uint8_t data = Serial.read();
+
+    if(receivedLength == 0 && data != TELEMETRY_SYNC)
+      continue;
+    received[receivedLength++] = data;
+    if(receivedLength < TELEMETRY_HEADER_SIZE)
+      continue;
+    if(received[2] > TELEMETRY_MAX_PAYLOAD) {
+      receivedLength = 0;
+      continue;
+    }
+    if(receivedLength < received[2] + TELEMETRY_OVERHEAD)
+      continue;
+
+    receivedLength = 0;
+    if(crc.Fast(&received[1], received[2] + 2) != received[received[2] + TELEMETRY_HEADER_SIZE])
+      continue;
+    *type = received[1];
+    *length = received[2];
+    for(uint8_t i = 0; i < received[2]; i++) {
+      payload[i] = received[TELEMETRY_HEADER_SIZE + i];
+    }
+    return true;
+  }
+  return false;
+}
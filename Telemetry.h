@@ -0,0 +1,104 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "crc.h"
+#include <stdint.h>
+
+//***************************
+// Frame layout
+//
+// [SYNC][TYPE][LENGTH][PAYLOAD ...][CRC]
+//
+// CRC is the CRC-8 of crc.h (poly 0x31, init 0xFF)
+// over TYPE, LENGTH and PAYLOAD. Multi-byte payload
+// fields are little-endian.
+//***************************
+#define TELEMETRY_SYNC            0x7E
+#define TELEMETRY_HEADER_SIZE     3       // sync, type, length
+#define TELEMETRY_OVERHEAD        4       // header + crc
+#define TELEMETRY_MAX_PAYLOAD     40
+#define TELEMETRY_MAX_FRAME       (TELEMETRY_MAX_PAYLOAD + TELEMETRY_OVERHEAD)
+#define TELEMETRY_MAX_EXPORT_PAYLOAD 128   // TELEMETRY_FRAME_EXPORT, device to host only
+#define TELEMETRY_BAUD            9600
+
+//***************************
+// Frame types
+//***************************
+#define TELEMETRY_FRAME_READING   0x01    // Measurement values
+#define TELEMETRY_FRAME_TRACE     0x02    // Raw I2C transaction (see I2CTrace.h)
+#define TELEMETRY_FRAME_COMMAND   0x03    // Command from the host
+#define TELEMETRY_FRAME_BURST     0x04    // Raw SGP30 signals (see Burst.h)
+#define TELEMETRY_FRAME_CONFIG    0x05    // Active configuration (see Config.h)
+#define TELEMETRY_FRAME_EXPORT    0x06    // Stored records (see RecordLog.h)
+#define TELEMETRY_FRAME_ENERGY    0x07    // Energy accounting (see Energy.h)
+
+//***************************
+// Command payload (host to device)
+//
+// [COMMAND][ARGUMENTS ...]
+//***************************
+#define TELEMETRY_COMMAND_BURST   0x01    // [SECONDS (1)]
+#define TELEMETRY_COMMAND_CONFIG  0x02    // [CONFIG BLOCK (16)], magic, sequence and CRC are ignored
+#define TELEMETRY_COMMAND_GET_CONFIG 0x03 // no arguments
+#define TELEMETRY_COMMAND_EXPORT  0x04    // [FIRST (4)][COUNT (2)][BAUD (1)], see RecordLog.h
+
+//***************************
+// Config payload (answer to both config commands)
+//
+// [STATUS (1)][CONFIG BLOCK (16)]
+//
+// STATUS    TELEMETRY_CONFIG_OK or TELEMETRY_CONFIG_REJECTED
+//           (invalid values, the old block stays active)
+//***************************
+#define TELEMETRY_CONFIG_OK       0x00
+#define TELEMETRY_CONFIG_REJECTED 0x01
+
+//***************************
+// Reading payload
+//
+// [DEVICE (4)][SEQUENCE (2)][TIME (4)][CO2 (2)][TVOC (2)][TEMP (2)][RH (2)]
+//
+// DEVICE    device ID (derived from the SGP30 serial ID)
+// SEQUENCE  incremented with every reading, wraps around
+// TIME      millis() of the measurement
+// CO2       ppm
+// TVOC      ppb
+// TEMP      signed, 1/100 degree Celsius
+// RH        1/100 percent relative humidity
+//***************************
+#define TELEMETRY_READING_SIZE    18
+
+//***************************
+// Methods
+//***************************
+class Telemetry {
+  private:
+    uint32_t deviceID;
+    uint16_t sequence;
+    uint8_t received[TELEMETRY_MAX_FRAME];
+    uint8_t receivedLength;
+
+  public:
+    Telemetry();
+    void begin(uint32_t device);
+    static uint8_t encodeFrame(uint8_t *frame, uint8_t type, const uint8_t *payload, uint8_t length);
+    static uint8_t encodeReading(uint8_t *frame, uint32_t device, uint16_t sequence, uint32_t time,
+                                 unsigned int co2, unsigned int tvoc, int temperature, unsigned int humidity);
+    static int toCentiUnits(float value);
+    static void putUInt16(uint8_t *buffer, uint16_t value);
+    static void putUInt32(uint8_t *buffer, uint32_t value);
+    void sendFrame(uint8_t type, const uint8_t *payload, uint8_t length);
+    void sendFrame(uint8_t type, const uint8_t *header, uint8_t headerLength,
+                   const volatile uint8_t *data, uint8_t dataLength);
+    void sendReading(unsigned int co2, unsigned int tvoc, float temperature, float humidity);
+    bool receiveFrame(uint8_t *type, uint8_t *payload, uint8_t *length);
+};
+
+#endif /* TELEMETRY_H_ */
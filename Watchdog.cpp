@@ -0,0 +1,45 @@
+/*
+ * Watchdog.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Watchdog.h"
+
+//*********************************************************
+// Start the RTC as watchdog
+//
+// input:   seconds     time without kick until the reset
+//
+// output:  none
+//
+// return:  none
+//*********************************************************
+void Watchdog::begin(uint8_t seconds) {
+
+  RTCMOD = (unsigned int)seconds * WATCHDOG_TICKS_PER_SECOND - 1;
+  RTCCTL = RTCSS__VLOCLK | RTCPS__1000 | RTCSR | RTCIE;
+}
+
+// Restart the counter
+void Watchdog::kick(void) {
+
+  RTCCTL |= RTCSR;
+}
+
+//*********************************************************
+// Software brown-out reset, the board starts from the
+// beginning like after power-up
+//*********************************************************
+void Watchdog::reset(void) {
+
+  PMMCTL0 = PMMPW | PMMSWBOR;
+}
+
+__attribute__((interrupt(RTC_VECTOR)))
+void watchdogISR(void) {
+
+  (void)RTCIV;
+  Watchdog::reset();
+}
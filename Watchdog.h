@@ -0,0 +1,35 @@
+/*
+ * Watchdog.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "Energia.h"
+#include <stdint.h>
+
+//***************************
+// Last resort if the I2C bus can't be recovered
+//
+// The WDT_A is the time base of millis()/sleep() in
+// Energia, so the RTC counter takes its place: clocked
+// by the VLO (10 kHz, runs in LPM3) and divided by 1000,
+// its overflow interrupt triggers a software BOR.
+// loop() kicks it after every scheduler run.
+//***************************
+#define WATCHDOG_TICKS_PER_SECOND   10      // VLO / 1000
+
+//***************************
+// Methods
+//***************************
+class Watchdog {
+  public:
+    static void begin(uint8_t seconds);
+    static void kick(void);
+    static void reset(void);
+};
+
+#endif /* WATCHDOG_H_ */
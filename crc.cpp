@@ -17,7 +17,11 @@
 #define WIDTH    (8 * sizeof(crcType))
 #define TOPBIT   ((unsigned long)1 << (WIDTH - 1))
 
-#if (REFLECT_DATA == TRUE)
+#if (REFLECT_DATA == true) || (REFLECT_REMAINDER == true)
+#define REFLECT_USED
+#endif
+
+#if (REFLECT_DATA == true)
 #undef  REFLECT_DATA
 #define REFLECT_DATA(X)			((crcType) reflect((X), 8))
 #else
@@ -25,7 +29,7 @@
 #define REFLECT_DATA(X)			((crcType)(X))
 #endif
 
-#if (REFLECT_REMAINDER == TRUE)
+#if (REFLECT_REMAINDER == true)
 #undef  REFLECT_REMAINDER
 #define REFLECT_REMAINDER(X)	((crcType) reflect((X), WIDTH))
 #else
@@ -45,6 +49,7 @@
  * Returns:		The reflection of the original data.
  *
  *********************************************************************/
+#ifdef REFLECT_USED
 static unsigned long reflect(unsigned long data, uint8_t nBits) {
 	unsigned long reflection = 0x00000000;
 	uint8_t bit;
@@ -66,6 +71,7 @@ static unsigned long reflect(unsigned long data, uint8_t nBits) {
 	return (reflection);
 
 } /* reflect() */
+#endif
 
 /*********************************************************************
  *
@@ -177,7 +183,25 @@ void CRC::Init(void) {
  *
  *********************************************************************/
 crcType CRC::Fast(uint8_t const message[], unsigned int nBytes) {
-	crcType remainder = INITIAL_REMAINDER;
+
+	return Fast(message, nBytes, INITIAL_REMAINDER);
+
+} /* crcFast() */
+
+/*********************************************************************
+ *
+ * Function:    crcFast()
+ * 
+ * Description: Continue a CRC over data in several pieces, e.g.
+ *				Fast(b, n, Fast(a, m)) equals the CRC of a and b.
+ *
+ * Notes:		Only valid without reflected remainder and final
+ *				XOR (CRC8, CRC_CCITT, CRC16).
+ *
+ * Returns:		The CRC of all pieces so far.
+ *
+ *********************************************************************/
+crcType CRC::Fast(uint8_t const message[], unsigned int nBytes, crcType remainder) {
 	uint8_t data;
 	unsigned int byte;
 
@@ -81,6 +81,7 @@ class CRC {
     void Init(void);
     crcType Slow(uint8_t const message[], unsigned int nBytes);
     crcType Fast(uint8_t const message[], unsigned int nBytes);
+    crcType Fast(uint8_t const message[], unsigned int nBytes, crcType remainder);
     uint8_t getOddParity(uint8_t p);
 };
 
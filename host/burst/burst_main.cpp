@@ -0,0 +1,167 @@
+/*
+ * burst_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Starts a raw signal burst of the SGP30 (see Burst.h) and
+ * writes the dumped H2 and ethanol signals as CSV. A file
+ * with a captured dump is decoded without sending a command.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/shim -Ihost/common -Ihost/crc -I. -o lp_burst \
+ *       host/burst/burst_main.cpp host/common/FrameScanner.cpp host/common/SerialPort.cpp \
+ *       host/crc/SlicedCRC.cpp
+ *
+ * Usage:
+ *   lp_burst [-b baud] [-s seconds] [-o out.csv] source
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "Burst.h"
+#include "FrameScanner.h"
+#include "SerialPort.h"
+#include "SlicedCRC.h"
+#include "Telemetry.h"
+
+struct Sample {
+  bool received;
+  uint16_t time;
+  uint16_t h2;
+  uint16_t ethanol;
+};
+
+static bool sendBurstCommand(int fd, uint8_t seconds) {
+
+  uint8_t frame[TELEMETRY_OVERHEAD + 2] = {TELEMETRY_SYNC, TELEMETRY_FRAME_COMMAND, 2,
+                                           TELEMETRY_COMMAND_BURST, seconds, 0};
+  frame[sizeof(frame) - 1] = SlicedCRC::compute(&frame[1], sizeof(frame) - 2);
+  return write(fd, frame, sizeof(frame)) == (ssize_t)sizeof(frame);
+}
+
+int main(int argc, char **argv) {
+
+  unsigned long baud = 9600;
+  int seconds = 5;
+  const char *outputPath = "-";
+  const char *path = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-b") && i + 1 < argc) baud = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc) seconds = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-o") && i + 1 < argc) outputPath = argv[++i];
+    else path = argv[i];
+  }
+  if(!path || seconds < 1 || seconds > BURST_MAX_SECONDS) {
+    fprintf(stderr, "usage: %s [-b baud] [-s seconds (1..%d)] [-o out.csv] source\n", argv[0], BURST_MAX_SECONDS);
+    return 2;
+  }
+
+  int fd = openSerialPort(path, baud, O_RDWR);
+  if(fd < 0)
+    fd = openSerialPort(path, baud, O_RDONLY);
+  if(fd < 0) {
+    perror(path);
+    return 1;
+  }
+  bool device = isatty(fd);
+  if(device) {
+    tcflush(fd, TCIFLUSH);
+    if(!sendBurstCommand(fd, seconds)) {
+      perror("write");
+      return 1;
+    }
+    fprintf(stderr, "burst of %d s started\n", seconds);
+  }
+
+  FrameScanner scanner;
+  Frame frame;
+  std::vector<Sample> samples;
+  long total = -1, received = 0, errors = 0;
+  // Device: sampling time, then at most 5 s between two frames
+  int timeout = (seconds + 5) * 1000;
+
+  while(total < 0 || received < total) {
+    if(device) {
+      struct pollfd p = {fd, POLLIN, 0};
+      if(poll(&p, 1, timeout) <= 0) {
+        fprintf(stderr, "timeout\n");
+        break;
+      }
+    }
+    uint8_t buffer[4096];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if(n <= 0)
+      break;
+    scanner.feed(buffer, n);
+
+    while(scanner.next(&frame)) {
+      if(frame.type != TELEMETRY_FRAME_BURST || frame.length < BURST_FRAME_HEADER)
+        continue;
+      uint16_t index = getUInt16(frame.payload);
+      uint16_t count = getUInt16(frame.payload + 2);
+      // A new burst replaces an incomplete one
+      if(index == 0 || total != count) {
+        if(total >= 0 && received < total)
+          fprintf(stderr, "incomplete burst dropped\n");
+        samples.assign(count, Sample());
+        total = count;
+        received = 0;
+      }
+      errors = getUInt16(frame.payload + 4);
+      timeout = 5000;
+
+      const uint8_t *p = frame.payload + BURST_FRAME_HEADER;
+      for(int i = 0; i < (frame.length - BURST_FRAME_HEADER) / BURST_SAMPLE_SIZE; i++) {
+        size_t k = index + i;
+        if(k >= samples.size())
+          break;
+        if(!samples[k].received)
+          received++;
+        samples[k].received = true;
+        samples[k].time = getUInt16(p);
+        samples[k].h2 = getUInt16(p + 2);
+        samples[k].ethanol = getUInt16(p + 4);
+        p += BURST_SAMPLE_SIZE;
+      }
+    }
+  }
+  close(fd);
+
+  if(total < 0) {
+    fprintf(stderr, "no burst received\n");
+    return 1;
+  }
+
+  FILE *output = strcmp(outputPath, "-") ? fopen(outputPath, "w") : stdout;
+  if(!output) {
+    perror(outputPath);
+    return 1;
+  }
+  fprintf(output, "time_ms,h2,ethanol\n");
+  long first = -1, last = -1;
+  for(size_t i = 0; i < samples.size(); i++) {
+    if(!samples[i].received)
+      continue;
+    fprintf(output, "%u,%u,%u\n", samples[i].time, samples[i].h2, samples[i].ethanol);
+    if(first < 0)
+      first = i;
+    last = i;
+  }
+  if(output != stdout)
+    fclose(output);
+
+  double span = last > first ? (samples[last].time - samples[first].time) / 1000.0 : 0;
+  fprintf(stderr, "%ld of %ld samples, %ld checksum errors, %.1f Hz, %lu bad frames\n",
+          received, total, errors, span > 0 ? (last - first) / span : 0.0,
+          (unsigned long)scanner.framesBadCRC);
+  return received == total ? 0 : 1;
+}
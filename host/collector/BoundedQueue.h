@@ -0,0 +1,64 @@
+/*
+ * BoundedQueue.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Blocking FIFO with fixed capacity. push() waits while the
+ * queue is full, which propagates backpressure to the producer.
+ */
+
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class BoundedQueue {
+  private:
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+
+  public:
+    explicit BoundedQueue(size_t maxItems) : capacity(maxItems), closed(false) {}
+
+    // return: false if the queue was closed
+    bool push(T item) {
+      std::unique_lock<std::mutex> guard(lock);
+      notFull.wait(guard, [this] { return items.size() < capacity || closed; });
+      if(closed)
+        return false;
+      items.push_back(std::move(item));
+      notEmpty.notify_one();
+      return true;
+    }
+
+    // return: false if the queue is closed and empty
+    bool pop(T *item) {
+      std::unique_lock<std::mutex> guard(lock);
+      notEmpty.wait(guard, [this] { return !items.empty() || closed; });
+      if(items.empty())
+        return false;
+      *item = std::move(items.front());
+      items.pop_front();
+      notFull.notify_one();
+      return true;
+    }
+
+    // Wake up all waiting threads, remaining items can still be popped
+    void close(void) {
+      std::lock_guard<std::mutex> guard(lock);
+      closed = true;
+      notEmpty.notify_all();
+      notFull.notify_all();
+    }
+};
+
+#endif /* BOUNDEDQUEUE_H_ */
@@ -0,0 +1,535 @@
+/*
+ * Collector.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Collector.h"
+#include "BoundedQueue.h"
+#include "SerialPort.h"
+
+#define REORDER_SHARDS  64
+
+typedef std::vector<Reading> ReadingBatch;
+
+//*********************************************************
+// CSV sink
+//*********************************************************
+CsvSink::CsvSink(FILE *output) : file(output) {
+
+  static char buffer[1 << 20];
+  setvbuf(file, buffer, _IOFBF, sizeof(buffer));
+  fputs("device,sequence,time,co2,tvoc,temperature,humidity\n", file);
+}
+
+// The buffer only collects a batch, a downstream pipe gets
+// every batch at once
+void CsvSink::write(const Reading *readings, size_t count) {
+
+  for(size_t i = 0; i < count; i++) {
+    const Reading &r = readings[i];
+    fprintf(file, "%08x,%u,%u,%u,%u,%d,%u\n", (unsigned int)r.device, r.sequence, (unsigned int)r.time,
+            r.co2, r.tvoc, r.temperature, r.humidity);
+  }
+  fflush(file);
+}
+
+void CsvSink::close(void) {
+
+  fflush(file);
+}
+
+CollectorConfig::CollectorConfig()
+  : workers(std::thread::hardware_concurrency()), chunkSize(65536), chunksPerSource(4),
+    outputBatches(256), reorderWindow(64), baud(9600) {
+  if(workers == 0)
+    workers = 1;
+}
+
+CollectorStats::CollectorStats()
+  : bytes(0), framesValid(0), framesBadCRC(0), bytesSkipped(0), readings(0),
+    reordered(0), duplicates(0), lost(0), restarts(0) {
+}
+
+//***************************
+// Serial stream, file or pipe
+//
+// The reader thread appends chunks, a worker takes them.
+// A source is handed to at most one worker at a time
+// ("scheduled"), so its frames are decoded and reordered in
+// order.
+//***************************
+struct Source {
+  std::string path;
+  int fd;
+  FrameScanner scanner;
+  std::mutex lock;
+  std::condition_variable space;
+  std::deque<std::vector<uint8_t> > chunks;
+  bool scheduled;
+  bool closed;
+
+  Source() : fd(-1), scheduled(false), closed(false) {}
+};
+
+//***************************
+// Restores the sequence order of each device
+//
+// Readings ahead of the expected sequence number are held
+// in a window. If a reading is further ahead than the window,
+// the missing ones are given up on and counted as lost.
+// Released readings stay in their slot until it is reused,
+// so a late copy can be told from a reboot.
+//***************************
+struct DeviceState {
+  bool started;
+  uint16_t next;
+  uint16_t held;
+  uint32_t lastTime;              // device time of the last released reading
+  std::vector<Reading> slots;
+  std::vector<uint8_t> present;
+
+  DeviceState() : started(false), next(0), held(0), lastTime(0) {}
+};
+
+struct Shard {
+  std::mutex lock;
+  std::unordered_map<uint32_t, DeviceState> devices;
+};
+
+struct Collector::Implementation {
+  CollectorConfig config;
+  ReadingSink *sink;
+  CollectorStats stats;
+  std::vector<Source *> sources;
+  std::unique_ptr<BoundedQueue<Source *> > ready;
+  BoundedQueue<ReadingBatch> output;
+  Shard shards[REORDER_SHARDS];
+  std::atomic<size_t> activeSources;
+  int stopPipe[2];                // readable after stop()
+
+  Implementation(const CollectorConfig &cfg, ReadingSink *s)
+    : config(cfg), sink(s), output(cfg.outputBatches), activeSources(0) {
+    if(pipe(stopPipe) != 0)
+      stopPipe[0] = stopPipe[1] = -1;
+  }
+
+  void schedule(Source *source);
+  void readSource(Source *source);
+  void work(void);
+  int process(Source *source, ReadingBatch *batch);
+  void reorder(const ReadingBatch &batch);
+  void release(DeviceState &state, ReadingBatch *out);
+  void advance(DeviceState &state, uint16_t next, ReadingBatch *out);
+  void releaseAll(DeviceState &state, ReadingBatch *out);
+  void flushReorder(void);
+  void write(void);
+};
+
+Collector::Collector(const CollectorConfig &config, ReadingSink *sink)
+  : impl(new Implementation(config, sink)) {
+}
+
+Collector::~Collector() {
+
+  for(size_t i = 0; i < impl->sources.size(); i++) {
+    if(impl->sources[i]->fd >= 0)
+      ::close(impl->sources[i]->fd);
+    delete impl->sources[i];
+  }
+  if(impl->stopPipe[0] >= 0) {
+    ::close(impl->stopPipe[0]);
+    ::close(impl->stopPipe[1]);
+  }
+  delete impl;
+}
+
+const CollectorStats &Collector::stats(void) const {
+
+  return impl->stats;
+}
+
+//*********************************************************
+// Open a serial device, FIFO or file as source
+//
+// input:   path        path of the source
+//
+// return:  false if the source can't be opened
+//*********************************************************
+bool Collector::addSource(const std::string &path) {
+
+  int fd = openSerialPort(path, impl->config.baud, O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  Source *source = new Source();
+  source->path = path;
+  source->fd = fd;
+  impl->sources.push_back(source);
+  return true;
+}
+
+//*********************************************************
+// Hand a source to the worker pool, unless a worker
+// already owns it. Called with source->lock held.
+//*********************************************************
+void Collector::Implementation::schedule(Source *source) {
+
+  if(!source->scheduled) {
+    source->scheduled = true;
+    ready->push(source);
+  }
+}
+
+//*********************************************************
+// Read a source until its end or stop()
+// A serial device has no end and a blocked read() isn't
+// woken by close(), so the reader waits in poll() on the
+// source and the stop pipe. Signals interrupt both calls.
+//*********************************************************
+void Collector::Implementation::readSource(Source *source) {
+
+  struct pollfd fds[2];
+  fds[0].fd = source->fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = stopPipe[0];
+  fds[1].events = POLLIN;
+
+  for(;;) {
+    std::vector<uint8_t> chunk(config.chunkSize);
+    ssize_t n = 0;
+    int events = poll(fds, stopPipe[0] >= 0 ? 2 : 1, -1);
+    if(events < 0 && errno == EINTR)
+      continue;
+    if(events > 0 && !(fds[1].revents & POLLIN)) {
+      do {
+        n = ::read(source->fd, &chunk[0], chunk.size());
+      } while(n < 0 && errno == EINTR);
+    }
+
+    std::unique_lock<std::mutex> guard(source->lock);
+    if(n <= 0) {
+      source->closed = true;
+      schedule(source);
+      return;
+    }
+    chunk.resize(n);
+    stats.bytes += n;
+    source->space.wait(guard, [&] { return source->chunks.size() < config.chunksPerSource; });
+    source->chunks.push_back(std::move(chunk));
+    schedule(source);
+  }
+}
+
+//*********************************************************
+// Decode the buffered chunks of a source, at most
+// chunksPerSource at once so busy sources can't starve
+// the others
+//
+// output:  *batch      decoded readings
+//
+// return:  SOURCE_IDLE, SOURCE_PENDING (more chunks buffered)
+//          or SOURCE_FINISHED (end of input reached)
+//
+// The source stays scheduled, work() hands it back after
+// the batch has been reordered.
+//*********************************************************
+enum { SOURCE_IDLE, SOURCE_PENDING, SOURCE_FINISHED };
+
+int Collector::Implementation::process(Source *source, ReadingBatch *batch) {
+
+  Frame frame;
+  Reading reading;
+
+  for(size_t n = 0; ; n++) {
+    std::vector<uint8_t> chunk;
+    {
+      std::lock_guard<std::mutex> guard(source->lock);
+      if(source->chunks.empty())
+        return source->closed ? SOURCE_FINISHED : SOURCE_IDLE;
+      if(n == config.chunksPerSource)
+        return SOURCE_PENDING;
+      chunk.swap(source->chunks.front());
+      source->chunks.pop_front();
+      source->space.notify_one();
+    }
+
+    unsigned long valid = source->scanner.framesValid;
+    unsigned long badCRC = source->scanner.framesBadCRC;
+    unsigned long skipped = source->scanner.bytesSkipped;
+
+    source->scanner.feed(&chunk[0], chunk.size());
+    while(source->scanner.next(&frame)) {
+      if(decodeReading(frame, &reading))
+        batch->push_back(reading);
+    }
+
+    stats.framesValid += source->scanner.framesValid - valid;
+    stats.framesBadCRC += source->scanner.framesBadCRC - badCRC;
+    stats.bytesSkipped += source->scanner.bytesSkipped - skipped;
+  }
+}
+
+void Collector::Implementation::work(void) {
+
+  Source *source;
+  ReadingBatch batch;
+
+  while(ready->pop(&source)) {
+    batch.clear();
+    int state = process(source, &batch);
+    if(!batch.empty())
+      reorder(batch);
+    if(state == SOURCE_FINISHED) {
+      if(--activeSources == 0)
+        ready->close();
+      continue;
+    }
+
+    // Another worker may take the source only now, after its
+    // readings are reordered. Chunks or the end of input that
+    // arrived meanwhile found it scheduled, so check again.
+    std::lock_guard<std::mutex> guard(source->lock);
+    if(source->chunks.empty() && !source->closed)
+      source->scheduled = false;
+    else
+      ready->push(source);
+  }
+}
+
+//*********************************************************
+// Move the expected sequence number of a device forward,
+// releasing held readings and counting missing ones
+//*********************************************************
+void Collector::Implementation::advance(DeviceState &state, uint16_t next, ReadingBatch *out) {
+
+  uint16_t mask = state.slots.size() - 1;
+
+  while(state.next != next) {
+    if(state.held == 0) {
+      stats.lost += (uint16_t)(next - state.next);
+      state.next = next;
+      break;
+    }
+    uint16_t slot = state.next & mask;
+    if(state.present[slot]) {
+      out->push_back(state.slots[slot]);
+      state.lastTime = state.slots[slot].time;
+      state.present[slot] = 0;
+      state.held--;
+    }
+    else stats.lost++;
+    state.next++;
+  }
+}
+
+void Collector::Implementation::release(DeviceState &state, ReadingBatch *out) {
+
+  uint16_t mask = state.slots.size() - 1;
+
+  while(state.held > 0 && state.present[state.next & mask]) {
+    uint16_t slot = state.next & mask;
+    out->push_back(state.slots[slot]);
+    state.lastTime = state.slots[slot].time;
+    state.present[slot] = 0;
+    state.held--;
+    state.next++;
+  }
+}
+
+// Give up on the missing readings and release all held ones
+void Collector::Implementation::releaseAll(DeviceState &state, ReadingBatch *out) {
+
+  while(state.held > 0) {
+    advance(state, state.next + 1, out);
+    release(state, out);
+  }
+}
+
+//*********************************************************
+// Telemetry::begin() starts the sequence numbers at 0 again
+// after a reboot, and millis() restarts as well. A reading
+// belongs to a new boot if it is
+//   - further behind the expected sequence number than the
+//     window,
+//   - behind and its time differs from the released reading
+//     with its sequence number (a duplicate has the same), or
+//   - ahead but older than the last released reading, unless
+//     millis() wrapped around after 49.7 days
+//*********************************************************
+static bool restarted(const DeviceState &state, const Reading &r) {
+
+  uint16_t window = state.slots.size();
+  uint16_t slot = r.sequence & (window - 1);
+  uint16_t distance = r.sequence - state.next;
+
+  if(distance < 0x8000)
+    return r.time < state.lastTime && !(state.lastTime >= 0xF0000000UL && r.time < 0x10000000UL);
+  if((uint16_t)(state.next - r.sequence) > window)
+    return true;
+  const Reading &released = state.slots[slot];
+  return !state.present[slot] && released.sequence == r.sequence && released.time != r.time;
+}
+
+void Collector::Implementation::reorder(const ReadingBatch &batch) {
+
+  uint16_t window = config.reorderWindow;
+  std::vector<ReadingBatch> perShard(REORDER_SHARDS);
+
+  for(size_t i = 0; i < batch.size(); i++) {
+    perShard[batch[i].device % REORDER_SHARDS].push_back(batch[i]);
+  }
+
+  for(unsigned int s = 0; s < REORDER_SHARDS; s++) {
+    if(perShard[s].empty())
+      continue;
+
+    ReadingBatch out;
+    Shard &shard = shards[s];
+    // Held while pushing, so batches of one device stay in order
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    for(size_t i = 0; i < perShard[s].size(); i++) {
+      const Reading &r = perShard[s][i];
+      DeviceState &state = shard.devices[r.device];
+      if(state.started && restarted(state, r)) {
+        // The old boot's readings go first
+        releaseAll(state, &out);
+        state.started = false;
+        stats.restarts++;
+      }
+      if(!state.started) {
+        state.started = true;
+        state.next = r.sequence;
+        state.lastTime = r.time;
+        state.slots.resize(window);
+        state.present.assign(window, 0);
+        // No slot holds a released reading yet
+        for(uint16_t k = 0; k < window; k++) {
+          state.slots[(uint16_t)(r.sequence + k) & (window - 1)].sequence = r.sequence + k;
+        }
+      }
+
+      uint16_t distance = r.sequence - state.next;
+      if(distance >= 0x8000) {
+        stats.duplicates++;
+        continue;
+      }
+      if(distance >= window) {
+        advance(state, r.sequence - window + 1, &out);
+        distance = window - 1;
+      }
+      if(distance == 0) {
+        out.push_back(r);
+        state.slots[r.sequence & (window - 1)] = r;
+        state.lastTime = r.time;
+        state.next++;
+        release(state, &out);
+        continue;
+      }
+
+      uint16_t slot = r.sequence & (window - 1);
+      if(state.present[slot]) {
+        stats.duplicates++;
+        continue;
+      }
+      state.slots[slot] = r;
+      state.present[slot] = 1;
+      state.held++;
+      stats.reordered++;
+    }
+
+    stats.readings += out.size();
+    if(!out.empty())
+      output.push(std::move(out));
+  }
+}
+
+//*********************************************************
+// Release all held readings at the end of the input
+//*********************************************************
+void Collector::Implementation::flushReorder(void) {
+
+  for(unsigned int s = 0; s < REORDER_SHARDS; s++) {
+    ReadingBatch out;
+    std::lock_guard<std::mutex> guard(shards[s].lock);
+    std::unordered_map<uint32_t, DeviceState>::iterator it;
+    for(it = shards[s].devices.begin(); it != shards[s].devices.end(); ++it) {
+      releaseAll(it->second, &out);
+    }
+    stats.readings += out.size();
+    if(!out.empty())
+      output.push(std::move(out));
+  }
+}
+
+void Collector::Implementation::write(void) {
+
+  ReadingBatch batch;
+
+  while(output.pop(&batch)) {
+    sink->write(&batch[0], batch.size());
+  }
+  sink->close();
+}
+
+//*********************************************************
+// End the collection: the readers stop, everything read so
+// far is decoded and written, then run() returns.
+// Only writes to a pipe, so it can be called from a signal
+// handler or another thread, also before run().
+//*********************************************************
+void Collector::stop(void) {
+
+  char byte = 0;
+  if(impl->stopPipe[1] >= 0) {
+    ssize_t written = ::write(impl->stopPipe[1], &byte, 1);
+    (void)written;
+  }
+}
+
+//*********************************************************
+// Collect until all sources reached their end or stop()
+//*********************************************************
+void Collector::run(void) {
+
+  Implementation &c = *impl;
+  if(c.sources.empty())
+    return;
+
+  // Every source is scheduled at most once, so this never blocks
+  c.ready.reset(new BoundedQueue<Source *>(c.sources.size()));
+  c.activeSources = c.sources.size();
+
+  std::thread writer(&Implementation::write, &c);
+  std::vector<std::thread> workers;
+  for(unsigned int i = 0; i < c.config.workers; i++) {
+    workers.push_back(std::thread(&Implementation::work, &c));
+  }
+  std::vector<std::thread> readers;
+  for(size_t i = 0; i < c.sources.size(); i++) {
+    readers.push_back(std::thread(&Implementation::readSource, &c, c.sources[i]));
+  }
+
+  for(size_t i = 0; i < readers.size(); i++) {
+    readers[i].join();
+  }
+  for(size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+  c.flushReorder();
+  c.output.close();
+  writer.join();
+}
@@ -0,0 +1,97 @@
+/*
+ * Collector.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Ingests telemetry (see Telemetry.h) from many boards at once.
+ *
+ *   reader thread per source -> worker pool (framing, CRC, decoding)
+ *     -> per-device reordering by sequence number -> writer thread -> sink
+ *
+ * All queues are bounded, so a slow sink throttles the readers
+ * instead of growing memory. run() returns when all sources
+ * reached their end or after stop(), in both cases with the
+ * held readings released and the sink closed.
+ */
+
+#ifndef COLLECTOR_H_
+#define COLLECTOR_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Reading.h"
+
+class ReadingSink {
+  public:
+    virtual ~ReadingSink() {}
+    // Readings of one device arrive in sequence order
+    virtual void write(const Reading *readings, size_t count) = 0;
+    virtual void close(void) {}
+};
+
+//***************************
+// One CSV line per reading
+//***************************
+class CsvSink : public ReadingSink {
+  private:
+    FILE *file;
+
+  public:
+    explicit CsvSink(FILE *output);
+    void write(const Reading *readings, size_t count);
+    void close(void);
+};
+
+//***************************
+// Discards the readings (throughput measurements)
+//***************************
+class NullSink : public ReadingSink {
+  public:
+    void write(const Reading *readings, size_t count) { (void)readings; (void)count; }
+};
+
+struct CollectorConfig {
+  unsigned int workers;           // decoding threads
+  size_t chunkSize;               // bytes per read() call
+  size_t chunksPerSource;         // buffered chunks before a reader blocks
+  size_t outputBatches;           // buffered batches before the workers block
+  unsigned int reorderWindow;     // readings held per device (power of 2)
+  unsigned long baud;             // applied to terminal sources
+
+  CollectorConfig();
+};
+
+struct CollectorStats {
+  std::atomic<unsigned long long> bytes;
+  std::atomic<unsigned long long> framesValid;
+  std::atomic<unsigned long long> framesBadCRC;
+  std::atomic<unsigned long long> bytesSkipped;
+  std::atomic<unsigned long long> readings;
+  std::atomic<unsigned long long> reordered;
+  std::atomic<unsigned long long> duplicates;
+  std::atomic<unsigned long long> lost;
+  std::atomic<unsigned long long> restarts;
+
+  CollectorStats();
+};
+
+class Collector {
+  private:
+    struct Implementation;
+    Implementation *impl;
+
+  public:
+    Collector(const CollectorConfig &config, ReadingSink *sink);
+    ~Collector();
+    bool addSource(const std::string &path);
+    void run(void);
+    void stop(void);
+    const CollectorStats &stats(void) const;
+};
+
+#endif /* COLLECTOR_H_ */
@@ -0,0 +1,68 @@
+/*
+ * TimeSeriesSink.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <chrono>
+
+#include "TimeSeriesSink.h"
+
+static int64_t hostMillis(void) {
+
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+TimeSeriesSink::TimeSeriesSink(TimeSeriesWriter *output, int64_t epoch)
+  : writer(output), fixedEpoch(epoch), lastSync(hostMillis()) {
+}
+
+void TimeSeriesSink::write(const Reading *readings, size_t count) {
+
+  for(size_t i = 0; i < count; i++) {
+    const Reading &r = readings[i];
+
+    std::unordered_map<uint32_t, Anchor>::iterator it = anchors.find(r.device);
+    if(it == anchors.end()) {
+      Anchor anchor;
+      anchor.epoch = fixedEpoch >= 0 ? fixedEpoch : hostMillis() - r.time;
+      anchor.lastTime = r.time;
+      it = anchors.insert(std::make_pair(r.device, anchor)).first;
+    }
+    Anchor &anchor = it->second;
+
+    if(r.time < anchor.lastTime) {
+      // millis() wraps after 49.7 days, anything else is a reboot
+      // (without the host clock the new boot starts with the last reading)
+      if(anchor.lastTime >= 0xF0000000UL && r.time < 0x10000000UL)
+        anchor.epoch += 0x100000000LL;
+      else if(fixedEpoch >= 0)
+        anchor.epoch += anchor.lastTime;
+      else
+        anchor.epoch = hostMillis() - r.time;
+    }
+    anchor.lastTime = r.time;
+
+    Sample sample;
+    sample.timestamp = anchor.epoch + r.time;
+    sample.sequence = r.sequence;
+    sample.co2 = r.co2;
+    sample.tvoc = r.tvoc;
+    sample.temperature = r.temperature;
+    sample.humidity = r.humidity;
+    writer->append(r.device, sample);
+  }
+
+  int64_t now = hostMillis();
+  if(now - lastSync >= TS_SINK_SYNC_INTERVAL) {
+    writer->sync();
+    lastSync = now;
+  }
+}
+
+void TimeSeriesSink::close(void) {
+
+  writer->close();
+}
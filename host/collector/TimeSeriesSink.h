@@ -0,0 +1,45 @@
+/*
+ * TimeSeriesSink.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Writes collected readings into a .lpts file (see
+ * host/tsdb/TimeSeriesFile.h). The boards only know their
+ * millis() clock, so each device is anchored to the host clock
+ * when it is seen first and again after a reboot.
+ *
+ * Complete chunks are written at once, the samples of slower
+ * devices at the latest every TS_SINK_SYNC_INTERVAL as shorter
+ * chunks, so a killed collector loses at most that much.
+ */
+
+#ifndef TIMESERIESSINK_H_
+#define TIMESERIESSINK_H_
+
+#include <unordered_map>
+
+#include "Collector.h"
+#include "TimeSeriesFile.h"
+
+#define TS_SINK_SYNC_INTERVAL   300000    // ms of host time
+
+class TimeSeriesSink : public ReadingSink {
+  private:
+    struct Anchor {
+      int64_t epoch;          // host time of device time 0
+      uint32_t lastTime;
+    };
+    TimeSeriesWriter *writer;
+    int64_t fixedEpoch;
+    int64_t lastSync;         // host time
+    std::unordered_map<uint32_t, Anchor> anchors;
+
+  public:
+    // fixedEpoch: anchor all devices here instead of the host clock (< 0: host clock)
+    TimeSeriesSink(TimeSeriesWriter *output, int64_t epoch = -1);
+    void write(const Reading *readings, size_t count);
+    void close(void);
+};
+
+#endif /* TIMESERIESSINK_H_ */
@@ -0,0 +1,139 @@
+/*
+ * collector_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Command line front end of the collector.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -pthread -Ihost/shim -Ihost/common -Ihost/crc -Ihost/tsdb -I. -o lp_collector \
+ *       host/collector/collector_main.cpp host/collector/Collector.cpp \
+ *       host/collector/TimeSeriesSink.cpp host/tsdb/TimeSeriesFile.cpp \
+ *       host/common/FrameScanner.cpp host/common/Reading.cpp host/common/SerialPort.cpp \
+ *       host/crc/SlicedCRC.cpp crc.cpp
+ *
+ * Usage:
+ *   lp_collector [-j workers] [-b baud] [-w window] [-e epoch] [-o out.csv|out.lpts|none] source...
+ *
+ * Sources are serial devices (/dev/ttyACM0), FIFOs or files.
+ * Output files ending in .lpts use the columnar format, the
+ * device clocks are anchored to the host clock or, with -e,
+ * to a fixed epoch (ms since 1970).
+ *
+ * SIGINT or SIGTERM ends the collection like the end of all
+ * sources: the held readings are written and the output is
+ * closed (.lpts with its index). A second signal aborts.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "crc.h"
+#include "Collector.h"
+#include "TimeSeriesSink.h"
+
+// Object of CRC calculation
+CRC crc;
+
+static Collector *running;
+
+static void onSignal(int signal) {
+
+  (void)signal;
+  if(running)
+    running->stop();
+}
+
+static int usage(const char *name) {
+
+  fprintf(stderr, "usage: %s [-j workers] [-b baud] [-w window (power of 2)] [-e epoch] [-o out.csv|out.lpts|none] source...\n", name);
+  return 2;
+}
+
+int main(int argc, char **argv) {
+
+  CollectorConfig config;
+  const char *outputPath = "-";
+  int64_t epoch = -1;
+  std::vector<const char *> paths;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-j") && i + 1 < argc) config.workers = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc) config.baud = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-w") && i + 1 < argc) config.reorderWindow = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-o") && i + 1 < argc) outputPath = argv[++i];
+    else if(!strcmp(argv[i], "-e") && i + 1 < argc) epoch = strtoll(argv[++i], 0, 10);
+    else if(argv[i][0] == '-')
+      return usage(argv[0]);
+    else paths.push_back(argv[i]);
+  }
+  if(paths.empty() || config.workers == 0 ||
+     config.reorderWindow == 0 || (config.reorderWindow & (config.reorderWindow - 1)) ||
+     config.reorderWindow > 0x4000)
+    return usage(argv[0]);
+
+  crc.Init();
+
+  ReadingSink *sink;
+  FILE *output = 0;
+  TimeSeriesWriter writer;
+  size_t pathLength = strlen(outputPath);
+  if(!strcmp(outputPath, "none"))
+    sink = new NullSink();
+  else if(pathLength > 5 && !strcmp(outputPath + pathLength - 5, ".lpts")) {
+    if(!writer.open(outputPath)) {
+      fprintf(stderr, "can't write %s\n", outputPath);
+      return 2;
+    }
+    sink = new TimeSeriesSink(&writer, epoch);
+  }
+  else {
+    output = strcmp(outputPath, "-") ? fopen(outputPath, "w") : stdout;
+    if(!output) {
+      fprintf(stderr, "can't write %s\n", outputPath);
+      return 2;
+    }
+    sink = new CsvSink(output);
+  }
+
+  Collector collector(config, sink);
+  // Opening a FIFO waits for its writer, a signal ends that too
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = onSignal;
+  action.sa_flags = SA_RESETHAND;
+  sigemptyset(&action.sa_mask);
+  running = &collector;
+  sigaction(SIGINT, &action, 0);
+  sigaction(SIGTERM, &action, 0);
+
+  for(size_t i = 0; i < paths.size(); i++) {
+    if(!collector.addSource(paths[i])) {
+      fprintf(stderr, "can't open %s\n", paths[i]);
+      return 2;
+    }
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  collector.run();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const CollectorStats &s = collector.stats();
+  fprintf(stderr, "sources: %u, workers: %u\n", (unsigned int)paths.size(), config.workers);
+  fprintf(stderr, "bytes: %llu, frames: %llu valid, %llu bad crc, %llu bytes skipped\n",
+          s.bytes.load(), s.framesValid.load(), s.framesBadCRC.load(), s.bytesSkipped.load());
+  fprintf(stderr, "readings: %llu written, %llu reordered, %llu duplicates, %llu lost, %llu restarts\n",
+          s.readings.load(), s.reordered.load(), s.duplicates.load(), s.lost.load(), s.restarts.load());
+  fprintf(stderr, "time: %.3f s, %.0f frames/s, %.1f MB/s\n", seconds,
+          seconds > 0 ? s.framesValid.load() / seconds : 0.0,
+          seconds > 0 ? s.bytes.load() / seconds / 1e6 : 0.0);
+
+  if(output && output != stdout)
+    fclose(output);
+  delete sink;
+  return 0;
+}
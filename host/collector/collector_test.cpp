@@ -0,0 +1,335 @@
+/*
+ * collector_test.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Feeds simulated fleets through the collector and fails if
+ * the result is wrong:
+ *
+ *   threads   several sources on 1 and on many workers, the
+ *             readings of every device must come out complete,
+ *             in order and identical to the single worker run
+ *   restart   devices reboot (sequence and millis() start
+ *             again), their readings must all be kept and the
+ *             .lpts timestamps must go on after the reboot
+ *
+ * The frames are built by the firmware's own encoder
+ * (Telemetry::encodeReading).
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -pthread -Ihost/shim -Ihost/common -Ihost/crc -Ihost/tsdb -I. -o lp_collector_test \
+ *       host/collector/collector_test.cpp host/collector/Collector.cpp \
+ *       host/collector/TimeSeriesSink.cpp host/tsdb/TimeSeriesFile.cpp \
+ *       host/common/FrameScanner.cpp host/common/Reading.cpp host/common/SerialPort.cpp \
+ *       host/crc/SlicedCRC.cpp host/shim/Shim.cpp Telemetry.cpp crc.cpp
+ *
+ * Usage:
+ *   lp_collector_test [-j workers] [-r rounds] [-t directory]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Energia.h"
+#include "Telemetry.h"
+#include "Collector.h"
+#include "TimeSeriesSink.h"
+
+// Object of CRC calculation
+CRC crc;
+
+//***************************
+// Keeps the readings of every device in arrival order
+//***************************
+class MemorySink : public ReadingSink {
+  public:
+    std::mutex lock;
+    std::map<uint32_t, std::vector<Reading> > devices;
+
+    void write(const Reading *readings, size_t count) {
+      std::lock_guard<std::mutex> guard(lock);
+      for(size_t i = 0; i < count; i++) {
+        devices[readings[i].device].push_back(readings[i]);
+      }
+    }
+};
+
+struct Stream {
+  std::string path;
+  FILE *file;
+};
+
+static bool openStreams(const std::string &directory, const char *name, unsigned int count,
+                        std::vector<Stream> *streams) {
+
+  streams->resize(count);
+  for(unsigned int s = 0; s < count; s++) {
+    Stream &stream = (*streams)[s];
+    stream.path = directory + "/" + name + "." + std::to_string(s) + ".bin";
+    stream.file = fopen(stream.path.c_str(), "wb");
+    if(!stream.file) {
+      fprintf(stderr, "can't write %s\n", stream.path.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+static void closeStreams(std::vector<Stream> *streams) {
+
+  for(size_t s = 0; s < streams->size(); s++) {
+    fclose((*streams)[s].file);
+  }
+}
+
+static void removeStreams(const std::vector<Stream> &streams) {
+
+  for(size_t s = 0; s < streams.size(); s++) {
+    unlink(streams[s].path.c_str());
+  }
+}
+
+static void writeReading(FILE *file, uint32_t device, uint16_t sequence, uint32_t time, int co2) {
+
+  uint8_t frame[TELEMETRY_READING_SIZE + TELEMETRY_OVERHEAD];
+  uint8_t length = Telemetry::encodeReading(frame, device, sequence, time, co2, co2 / 4, 2150, 4500);
+  fwrite(frame, 1, length, file);
+}
+
+struct Counts {
+  unsigned long long duplicates;
+  unsigned long long lost;
+  unsigned long long restarts;
+};
+
+// Small chunks, so the workers hand the sources around often
+static bool collect(const std::vector<Stream> &streams, unsigned int workers, ReadingSink *sink,
+                    Counts *counts) {
+
+  CollectorConfig config;
+  config.workers = workers;
+  config.chunkSize = 256;
+  config.chunksPerSource = 2;
+
+  Collector collector(config, sink);
+  for(size_t s = 0; s < streams.size(); s++) {
+    if(!collector.addSource(streams[s].path)) {
+      fprintf(stderr, "can't open %s\n", streams[s].path.c_str());
+      return false;
+    }
+  }
+  collector.run();
+  counts->duplicates = collector.stats().duplicates;
+  counts->lost = collector.stats().lost;
+  counts->restarts = collector.stats().restarts;
+  return true;
+}
+
+static bool sameReadings(const std::vector<Reading> &a, const std::vector<Reading> &b) {
+
+  if(a.size() != b.size())
+    return false;
+  for(size_t i = 0; i < a.size(); i++) {
+    if(a[i].sequence != b[i].sequence || a[i].time != b[i].time || a[i].co2 != b[i].co2)
+      return false;
+  }
+  return true;
+}
+
+//*********************************************************
+// Several sources, one and many workers
+//*********************************************************
+static bool testThreads(const std::string &directory, unsigned int workers, unsigned int rounds) {
+
+  const unsigned int devices = 200, readings = 500, sources = 4;
+  std::mt19937 random(1);
+  std::vector<Stream> streams;
+  std::vector<uint16_t> first(devices);
+
+  if(!openStreams(directory, "threads", sources, &streams))
+    return false;
+  for(unsigned int d = 0; d < devices; d++) {
+    first[d] = random() & 0xFFFF;
+  }
+  for(unsigned int n = 0; n < readings; n++) {
+    for(unsigned int d = 0; d < devices; d++) {
+      writeReading(streams[d % sources].file, 0x10000000 + d, first[d] + n, 5000 + n * 1000, 400 + random() % 600);
+    }
+  }
+  closeStreams(&streams);
+
+  bool ok = true;
+  MemorySink single;
+  Counts counts;
+  if(!collect(streams, 1, &single, &counts))
+    return false;
+  if(single.devices.size() != devices || counts.duplicates || counts.lost || counts.restarts) {
+    printf("  1 worker: %u devices, %llu duplicates, %llu lost, %llu restarts\n",
+           (unsigned int)single.devices.size(), counts.duplicates, counts.lost, counts.restarts);
+    ok = false;
+  }
+  for(std::map<uint32_t, std::vector<Reading> >::iterator it = single.devices.begin(); it != single.devices.end(); ++it) {
+    const std::vector<Reading> &list = it->second;
+    bool inOrder = list.size() == readings;
+    for(size_t i = 1; inOrder && i < list.size(); i++) {
+      inOrder = list[i].sequence == (uint16_t)(list[i - 1].sequence + 1);
+    }
+    if(!inOrder) {
+      printf("  1 worker: device %08x incomplete or out of order\n", (unsigned int)it->first);
+      ok = false;
+    }
+  }
+
+  for(unsigned int r = 0; r < rounds; r++) {
+    MemorySink many;
+    if(!collect(streams, workers, &many, &counts))
+      return false;
+    bool same = many.devices.size() == single.devices.size();
+    for(std::map<uint32_t, std::vector<Reading> >::iterator it = single.devices.begin(); same && it != single.devices.end(); ++it) {
+      same = sameReadings(it->second, many.devices[it->first]);
+    }
+    if(!same || counts.duplicates || counts.lost || counts.restarts) {
+      printf("  %u workers, round %u: %s, %llu duplicates, %llu lost, %llu restarts\n", workers, r + 1,
+             same ? "same readings" : "readings differ", counts.duplicates, counts.lost, counts.restarts);
+      ok = false;
+    }
+  }
+  removeStreams(streams);
+  printf("threads (%u sources, %u workers, %u rounds): %s\n", sources, workers, rounds, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+//*********************************************************
+// Reboots: after a long run, after a short run (sequence
+// numbers of both boots overlap within the window), just
+// before the sequence number wraps, and a millis() wrap
+// that is no reboot. One frame is sent twice.
+//*********************************************************
+struct Boot {
+  uint32_t device;
+  uint16_t sequence;
+  uint32_t time;
+  unsigned int readings;
+};
+
+static bool testRestart(const std::string &directory, unsigned int workers) {
+
+  const Boot boots[] = {
+    {0x20000001, 1000, 5000, 300}, {0x20000001, 0, 3000, 100},
+    {0x20000002, 0, 3000, 20},     {0x20000002, 0, 3500, 30},
+    {0x20000003, 65500, 8000, 30}, {0x20000003, 0, 3000, 40},
+    {0x20000004, 200, 0xFFFF0000UL, 200},
+  };
+  const unsigned int bootCount = sizeof(boots) / sizeof(boots[0]);
+  const int64_t epoch = 1760000000000LL;
+  std::vector<Stream> streams;
+  std::map<uint32_t, std::vector<Reading> > expected;
+
+  if(!openStreams(directory, "restart", 1, &streams))
+    return false;
+  for(unsigned int b = 0; b < bootCount; b++) {
+    for(unsigned int n = 0; n < boots[b].readings; n++) {
+      Reading r;
+      r.device = boots[b].device;
+      r.sequence = boots[b].sequence + n;
+      r.time = boots[b].time + n * 1000;
+      r.co2 = 400 + b * 100 + n;
+      writeReading(streams[0].file, r.device, r.sequence, r.time, r.co2);
+      if(b == 0 && n == 10)
+        writeReading(streams[0].file, r.device, r.sequence, r.time, r.co2);
+      expected[r.device].push_back(r);
+    }
+  }
+  closeStreams(&streams);
+
+  bool ok = true;
+  MemorySink memory;
+  Counts counts;
+  if(!collect(streams, workers, &memory, &counts))
+    return false;
+  if(counts.duplicates != 1 || counts.lost || counts.restarts != 3) {
+    printf("  %llu duplicates (1), %llu lost (0), %llu restarts (3)\n", counts.duplicates, counts.lost,
+           counts.restarts);
+    ok = false;
+  }
+  for(std::map<uint32_t, std::vector<Reading> >::iterator it = expected.begin(); it != expected.end(); ++it) {
+    if(!sameReadings(it->second, memory.devices[it->first])) {
+      printf("  device %08x: %u of %u readings, or out of order\n", (unsigned int)it->first,
+             (unsigned int)memory.devices[it->first].size(), (unsigned int)it->second.size());
+      ok = false;
+    }
+  }
+
+  // The .lpts timestamps of a device must keep increasing
+  std::string path = directory + "/restart.lpts";
+  TimeSeriesWriter writer;
+  TimeSeriesReader reader;
+  if(!writer.open(path)) {
+    fprintf(stderr, "can't write %s\n", path.c_str());
+    return false;
+  }
+  TimeSeriesSink sink(&writer, epoch);
+  if(!collect(streams, workers, &sink, &counts) || !reader.open(path)) {
+    fprintf(stderr, "can't read %s\n", path.c_str());
+    return false;
+  }
+  std::map<uint32_t, std::vector<Sample> > stored;
+  std::vector<Sample> samples;
+  for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+    samples.clear();
+    reader.decode(i, &samples);
+    std::vector<Sample> &list = stored[reader.chunkRef(i).device];
+    list.insert(list.end(), samples.begin(), samples.end());
+  }
+  for(std::map<uint32_t, std::vector<Reading> >::iterator it = expected.begin(); it != expected.end(); ++it) {
+    const std::vector<Sample> &list = stored[it->first];
+    bool increasing = list.size() == it->second.size();
+    for(size_t i = 1; increasing && i < list.size(); i++) {
+      increasing = list[i].timestamp > list[i - 1].timestamp;
+    }
+    if(!increasing) {
+      printf("  device %08x: %u of %u samples stored, or timestamps not increasing\n", (unsigned int)it->first,
+             (unsigned int)list.size(), (unsigned int)it->second.size());
+      ok = false;
+    }
+  }
+  reader.close();
+  unlink(path.c_str());
+  removeStreams(streams);
+  printf("restart (%u devices, %u boots): %s\n", (unsigned int)expected.size(), bootCount, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main(int argc, char **argv) {
+
+  unsigned int workers = 8;
+  unsigned int rounds = 20;
+  std::string directory = "/tmp";
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-j") && i + 1 < argc) workers = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc) rounds = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc) directory = argv[++i];
+    else {
+      fprintf(stderr, "usage: %s [-j workers] [-r rounds] [-t directory]\n", argv[0]);
+      return 2;
+    }
+  }
+  if(workers < 2) {
+    fprintf(stderr, "workers must be at least 2\n");
+    return 2;
+  }
+
+  crc.Init();
+  bool ok = testThreads(directory, workers, rounds);
+  ok &= testRestart(directory, workers);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+/*
+ * loadgen.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Simulates a fleet of boards for collector throughput tests.
+ * The frames are built by the firmware's own encoder
+ * (Telemetry::encodeReading), so they are bit-identical to
+ * what a board sends.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/shim -I. -o lp_loadgen \
+ *       host/collector/loadgen.cpp host/shim/Shim.cpp Telemetry.cpp crc.cpp
+ *
+ * Usage:
+ *   lp_loadgen [-d devices] [-n readings] [-s streams] [-r reorder] [-c corrupt]
+ *              [-S seed] prefix|-
+ *
+ *   Writes <prefix>.<stream>.bin, or one stream to stdout for "-".
+ *   reorder   frames of a stream are shuffled within this window
+ *   corrupt   probability (0..1) that a frame gets a flipped bit
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Energia.h"
+#include "Telemetry.h"
+
+// Object of CRC calculation
+CRC crc;
+
+struct SimulatedDevice {
+  uint32_t id;
+  uint16_t sequence;
+  uint32_t time;
+  int co2;
+  int tvoc;
+  int temperature;
+  int humidity;
+};
+
+static int clamp(int value, int low, int high) {
+
+  return value < low ? low : (value > high ? high : value);
+}
+
+int main(int argc, char **argv) {
+
+  unsigned long devices = 1000;
+  unsigned long readings = 100;
+  unsigned int streams = 1;
+  unsigned int reorder = 0;
+  double corrupt = 0;
+  unsigned long seed = 1;
+  const char *prefix = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-d") && i + 1 < argc) devices = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-n") && i + 1 < argc) readings = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc) streams = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc) reorder = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-c") && i + 1 < argc) corrupt = atof(argv[++i]);
+    else if(!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], 0, 10);
+    else prefix = argv[i];
+  }
+  if(!prefix || streams == 0 || (!strcmp(prefix, "-") && streams != 1)) {
+    fprintf(stderr, "usage: %s [-d devices] [-n readings] [-s streams] [-r reorder] [-c corrupt] [-S seed] prefix|-\n", argv[0]);
+    return 2;
+  }
+
+  crc.Init();
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<double> chance(0, 1);
+
+  std::vector<SimulatedDevice> fleet(devices);
+  for(unsigned long d = 0; d < devices; d++) {
+    fleet[d].id = 0x10000000 + d;
+    fleet[d].sequence = random() & 0xFFFF;
+    fleet[d].time = random() % 100000;
+    fleet[d].co2 = 400 + random() % 600;
+    fleet[d].tvoc = random() % 200;
+    fleet[d].temperature = 1800 + random() % 800;
+    fleet[d].humidity = 3000 + random() % 3000;
+  }
+
+  unsigned long long frames = 0, bytes = 0;
+  for(unsigned int s = 0; s < streams; s++) {
+    FILE *file = stdout;
+    if(strcmp(prefix, "-")) {
+      std::string path = std::string(prefix) + "." + std::to_string(s) + ".bin";
+      file = fopen(path.c_str(), "wb");
+      if(!file) {
+        fprintf(stderr, "can't write %s\n", path.c_str());
+        return 2;
+      }
+    }
+
+    std::vector<std::vector<uint8_t> > pending;
+    for(unsigned long n = 0; n < readings; n++) {
+      for(unsigned long d = s; d < devices; d += streams) {
+        SimulatedDevice &dev = fleet[d];
+        dev.time += 1000;
+        dev.co2 = clamp(dev.co2 + (int)(random() % 21) - 10, 400, 60000);
+        dev.tvoc = clamp(dev.tvoc + (int)(random() % 5) - 2, 0, 60000);
+        dev.temperature = clamp(dev.temperature + (int)(random() % 5) - 2, -4000, 12500);
+        dev.humidity = clamp(dev.humidity + (int)(random() % 7) - 3, 0, 10000);
+
+        std::vector<uint8_t> frame(TELEMETRY_READING_SIZE + TELEMETRY_OVERHEAD);
+        Telemetry::encodeReading(&frame[0], dev.id, dev.sequence++, dev.time, dev.co2, dev.tvoc,
+                                 dev.temperature, dev.humidity);
+        if(corrupt > 0 && chance(random) < corrupt)
+          frame[1 + random() % (frame.size() - 1)] ^= 1 << (random() % 8);
+        pending.push_back(frame);
+      }
+
+      // Emit the oldest frames, shuffled within the reorder window
+      while(pending.size() > reorder) {
+        size_t pick = reorder ? random() % (reorder + 1) : 0;
+        if(pick >= pending.size())
+          pick = pending.size() - 1;
+        fwrite(&pending[pick][0], 1, pending[pick].size(), file);
+        bytes += pending[pick].size();
+        frames++;
+        pending.erase(pending.begin() + pick);
+      }
+    }
+    for(size_t i = 0; i < pending.size(); i++) {
+      fwrite(&pending[i][0], 1, pending[i].size(), file);
+      bytes += pending[i].size();
+      frames++;
+    }
+    if(file != stdout)
+      fclose(file);
+  }
+
+  fprintf(stderr, "%llu frames, %llu bytes, %u streams\n", frames, bytes, streams);
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * FrameScanner.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <string.h>
+#include "FrameScanner.h"
+#include "Telemetry.h"
+#include "SlicedCRC.h"
+
+FrameScanner::FrameScanner()
+  : position(0), framesValid(0), framesBadCRC(0), bytesSkipped(0) {
+}
+
+//*********************************************************
+// Append received bytes to the scanner
+//*********************************************************
+void FrameScanner::feed(const uint8_t *data, size_t length) {
+
+  // Drop consumed bytes before the buffer grows
+  if(position > 4096 && position * 2 > pending.size()) {
+    pending.erase(pending.begin(), pending.begin() + position);
+    position = 0;
+  }
+  pending.insert(pending.end(), data, data + length);
+}
+
+//*********************************************************
+// Extract the next valid frame
+//
+// output:  *frame      type, length and payload
+//
+// return:  false if no complete frame is buffered
+//*********************************************************
+bool FrameScanner::next(Frame *frame) {
+
+  while(position < pending.size()) {
+    const uint8_t *p = &pending[position];
+    size_t remaining = pending.size() - position;
+
+    if(p[0] != TELEMETRY_SYNC) {
+      position++;
+      bytesSkipped++;
+      continue;
+    }
+    if(remaining < TELEMETRY_HEADER_SIZE)
+      return false;
+    // Only export blocks are longer
+    if(p[2] > (p[1] == TELEMETRY_FRAME_EXPORT ? TELEMETRY_MAX_EXPORT_PAYLOAD : TELEMETRY_MAX_PAYLOAD)) {
+      position++;
+      bytesSkipped++;
+      continue;
+    }
+    size_t frameLength = p[2] + TELEMETRY_OVERHEAD;
+    if(remaining < frameLength)
+      return false;
+
+    // Resynchronize on the next byte if the checksum fails
+    if(SlicedCRC::compute(&p[1], p[2] + 2) != p[frameLength - 1]) {
+      framesBadCRC++;
+      position++;
+      bytesSkipped++;
+      continue;
+    }
+
+    frame->type = p[1];
+    frame->length = p[2];
+    memcpy(frame->payload, &p[TELEMETRY_HEADER_SIZE], p[2]);
+    position += frameLength;
+    framesValid++;
+    return true;
+  }
+  return false;
+}
+
+uint16_t getUInt16(const uint8_t *buffer) {
+
+  return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+uint32_t getUInt32(const uint8_t *buffer) {
+
+  return (uint32_t)getUInt16(buffer) | ((uint32_t)getUInt16(buffer + 2) << 16);
+}
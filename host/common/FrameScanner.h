@@ -0,0 +1,43 @@
+/*
+ * FrameScanner.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Splits a raw serial byte stream into telemetry frames
+ * (see Telemetry.h). Bytes outside of valid frames, e.g.
+ * the drivers' error messages, are skipped.
+ */
+
+#ifndef FRAMESCANNER_H_
+#define FRAMESCANNER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+struct Frame {
+  uint8_t type;
+  uint8_t length;
+  uint8_t payload[256];
+};
+
+class FrameScanner {
+  private:
+    std::vector<uint8_t> pending;
+    size_t position;
+
+  public:
+    unsigned long framesValid;
+    unsigned long framesBadCRC;
+    unsigned long bytesSkipped;
+
+    FrameScanner();
+    void feed(const uint8_t *data, size_t length);
+    bool next(Frame *frame);
+};
+
+uint16_t getUInt16(const uint8_t *buffer);
+uint32_t getUInt32(const uint8_t *buffer);
+
+#endif /* FRAMESCANNER_H_ */
@@ -0,0 +1,34 @@
+/*
+ * Reading.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include "Reading.h"
+#include "Telemetry.h"
+
+//*********************************************************
+// Decode the payload of a reading frame
+//
+// input:   frame       frame with valid checksum
+//
+// output:  *reading    decoded values
+//
+// return:  false if the frame is no reading frame
+//*********************************************************
+bool decodeReading(const Frame &frame, Reading *reading) {
+
+  if(frame.type != TELEMETRY_FRAME_READING || frame.length != TELEMETRY_READING_SIZE)
+    return false;
+
+  const uint8_t *p = frame.payload;
+  reading->device = getUInt32(&p[0]);
+  reading->sequence = getUInt16(&p[4]);
+  reading->time = getUInt32(&p[6]);
+  reading->co2 = getUInt16(&p[10]);
+  reading->tvoc = getUInt16(&p[12]);
+  reading->temperature = (int16_t)getUInt16(&p[14]);
+  reading->humidity = getUInt16(&p[16]);
+  return true;
+}
@@ -0,0 +1,29 @@
+/*
+ * Reading.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Decoded reading frame (see Telemetry.h). Values keep the
+ * firmware's integer units.
+ */
+
+#ifndef READING_H_
+#define READING_H_
+
+#include <stdint.h>
+#include "FrameScanner.h"
+
+struct Reading {
+  uint32_t device;
+  uint16_t sequence;
+  uint32_t time;          // device millis()
+  uint16_t co2;           // ppm
+  uint16_t tvoc;          // ppb
+  int16_t temperature;    // 1/100 degree Celsius
+  uint16_t humidity;      // 1/100 percent
+};
+
+bool decodeReading(const Frame &frame, Reading *reading);
+
+#endif /* READING_H_ */
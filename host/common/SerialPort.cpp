@@ -0,0 +1,74 @@
+/*
+ * SerialPort.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "SerialPort.h"
+
+static speed_t baudConstant(unsigned long baud) {
+
+  switch(baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    default: return B9600;
+  }
+}
+
+//*********************************************************
+// Open a serial device, FIFO or file
+//
+// input:   path        path of the device or file
+//          baud        baud rate of serial devices
+//          flags       O_RDONLY or O_RDWR
+//
+// return:  file descriptor, -1 on error
+//*********************************************************
+int openSerialPort(const std::string &path, unsigned long baud, int flags) {
+
+  int fd = open(path.c_str(), flags | O_NOCTTY);
+  if(fd < 0)
+    return -1;
+
+  if(isatty(fd)) {
+    struct termios tty;
+    if(tcgetattr(fd, &tty) == 0) {
+      cfmakeraw(&tty);
+      cfsetispeed(&tty, baudConstant(baud));
+      cfsetospeed(&tty, baudConstant(baud));
+      tty.c_cc[VMIN] = 1;
+      tty.c_cc[VTIME] = 0;
+      tcsetattr(fd, TCSANOW, &tty);
+    }
+  }
+  return fd;
+}
+
+//*********************************************************
+// Change the baud rate of an open serial device, output
+// that is still queued is sent with the old one
+//
+// input:   fd          file descriptor
+//          baud        new baud rate
+//
+// return:  false if fd is no serial device
+//*********************************************************
+bool setSerialBaud(int fd, unsigned long baud) {
+
+  struct termios tty;
+  if(!isatty(fd) || tcgetattr(fd, &tty) != 0)
+    return false;
+  tcdrain(fd);
+  cfsetispeed(&tty, baudConstant(baud));
+  cfsetospeed(&tty, baudConstant(baud));
+  return tcsetattr(fd, TCSANOW, &tty) == 0;
+}
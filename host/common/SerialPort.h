@@ -0,0 +1,19 @@
+/*
+ * SerialPort.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Opens serial devices in raw mode; FIFOs and files are
+ * opened unchanged.
+ */
+
+#ifndef SERIALPORT_H_
+#define SERIALPORT_H_
+
+#include <string>
+
+int openSerialPort(const std::string &path, unsigned long baud, int flags);
+bool setSerialBaud(int fd, unsigned long baud);
+
+#endif /* SERIALPORT_H_ */
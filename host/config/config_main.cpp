@@ -0,0 +1,246 @@
+/*
+ * config_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Shows and changes the configuration stored in FRAM (see
+ * Config.h). The device writes a new block into its second
+ * slot and answers with the configuration that is active
+ * afterwards. A file with a captured answer is decoded
+ * without sending a command.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/shim -Ihost/common -Ihost/crc -I. -o lp_config \
+ *       host/config/config_main.cpp host/common/FrameScanner.cpp host/common/SerialPort.cpp \
+ *       host/crc/SlicedCRC.cpp
+ *
+ * Usage:
+ *   lp_config [-b baud] source [key=value ...]
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Config.h"
+#include "FrameScanner.h"
+#include "GUI.h"
+#include "SerialPort.h"
+#include "SHT21.h"
+#include "SlicedCRC.h"
+#include "Telemetry.h"
+
+#define ANSWER_TIMEOUT    3000      // ms, the device sleeps up to 1 s
+
+static const char *screens[] = {"", "co2", "temp", "rh"};
+static const char *telemetryModes[] = {"off", "readings"};
+
+// SHT21 resolution by the humidity bits
+static const struct {
+  unsigned bits;
+  uint8_t value;
+} resolutions[] = {
+  {12, SHT21_RESOLUTION_12_14}, {11, SHT21_RESOLUTION_11_11},
+  {10, SHT21_RESOLUTION_10_13}, {8, SHT21_RESOLUTION_8_12},
+};
+
+static int lookup(const char *const *names, int count, const char *name) {
+
+  for(int i = 0; i < count; i++) {
+    if(!strcmp(names[i], name))
+      return i;
+  }
+  return -1;
+}
+
+static void print(const ConfigBlock &c) {
+
+  unsigned bits = 0;
+  for(size_t i = 0; i < sizeof(resolutions) / sizeof(resolutions[0]); i++) {
+    if(resolutions[i].value == c.sht21Resolution)
+      bits = resolutions[i].bits;
+  }
+  printf("version=%u\n", c.version);
+  printf("sequence=%u%s\n", c.sequence, c.sequence ? "" : " (defaults)");
+  printf("sht21_interval=%u\n", c.sht21Interval);
+  printf("sgp30_interval=%u\n", c.sgp30Interval);
+  printf("resolution=%u\n", bits);
+  printf("filter=%u\n", c.filterShift);
+  printf("max_window=%u\n", c.maxWindow);
+  printf("telemetry=%s\n", c.telemetryMode <= CONFIG_TELEMETRY_READINGS ? telemetryModes[c.telemetryMode] : "?");
+  printf("divider=%u\n", c.telemetryDivider);
+  printf("log_interval=%u\n", c.logInterval);
+  printf("screen=%s\n", c.screen >= SCREEN_CO2 && c.screen <= SCREEN_RH ? screens[c.screen] : "?");
+}
+
+//*********************************************************
+// Apply one key=value argument
+//*********************************************************
+static bool set(ConfigBlock *c, const char *argument) {
+
+  char key[32];
+  const char *value = strchr(argument, '=');
+  if(!value || value - argument >= (long)sizeof(key))
+    return false;
+  memcpy(key, argument, value - argument);
+  key[value - argument] = 0;
+  value++;
+
+  char *end;
+  unsigned long number = strtoul(value, &end, 10);
+  bool isNumber = *value && !*end;
+
+  if(!strcmp(key, "sht21_interval") && isNumber && number <= 0xFFFF)
+    c->sht21Interval = number;
+  else if(!strcmp(key, "sgp30_interval") && isNumber && number <= 0xFFFF)
+    c->sgp30Interval = number;
+  else if(!strcmp(key, "filter") && isNumber && number <= CONFIG_MAX_FILTER_SHIFT)
+    c->filterShift = number;
+  else if(!strcmp(key, "max_window") && isNumber && number <= 0xFF)
+    c->maxWindow = number;
+  else if(!strcmp(key, "log_interval") && isNumber && number <= 0xFF)
+    c->logInterval = number;
+  else if(!strcmp(key, "divider") && isNumber && number >= 1 && number <= 0xFF)
+    c->telemetryDivider = number;
+  else if(!strcmp(key, "telemetry") && lookup(telemetryModes, 2, value) >= 0)
+    c->telemetryMode = lookup(telemetryModes, 2, value);
+  else if(!strcmp(key, "screen") && lookup(screens, 4, value) >= SCREEN_CO2)
+    c->screen = lookup(screens, 4, value);
+  else if(!strcmp(key, "resolution") && isNumber) {
+    for(size_t i = 0; i < sizeof(resolutions) / sizeof(resolutions[0]); i++) {
+      if(resolutions[i].bits == number) {
+        c->sht21Resolution = resolutions[i].value;
+        return true;
+      }
+    }
+    return false;
+  }
+  else
+    return false;
+  return true;
+}
+
+static bool sendCommand(int fd, const uint8_t *payload, uint8_t length) {
+
+  uint8_t frame[TELEMETRY_MAX_FRAME] = {TELEMETRY_SYNC, TELEMETRY_FRAME_COMMAND, length};
+  memcpy(&frame[TELEMETRY_HEADER_SIZE], payload, length);
+  frame[TELEMETRY_HEADER_SIZE + length] = SlicedCRC::compute(&frame[1], length + 2);
+  ssize_t size = length + TELEMETRY_OVERHEAD;
+  return write(fd, frame, size) == size;
+}
+
+//*********************************************************
+// Wait for the next config answer
+//*********************************************************
+static bool receiveConfig(int fd, bool device, FrameScanner *scanner, uint8_t *status, ConfigBlock *c) {
+
+  Frame frame;
+
+  for(;;) {
+    while(scanner->next(&frame)) {
+      if(frame.type != TELEMETRY_FRAME_CONFIG || frame.length != 1 + CONFIG_BLOCK_SIZE)
+        continue;
+      *status = frame.payload[0];
+      memcpy(c, &frame.payload[1], CONFIG_BLOCK_SIZE);
+      return true;
+    }
+    if(device) {
+      struct pollfd p = {fd, POLLIN, 0};
+      if(poll(&p, 1, ANSWER_TIMEOUT) <= 0)
+        return false;
+    }
+    uint8_t buffer[256];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if(n <= 0)
+      return false;
+    scanner->feed(buffer, n);
+  }
+}
+
+int main(int argc, char **argv) {
+
+  unsigned long baud = 9600;
+  const char *path = 0;
+  int first = argc;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-b") && i + 1 < argc) baud = strtoul(argv[++i], 0, 10);
+    else if(!path) path = argv[i];
+    else {
+      first = i;
+      break;
+    }
+  }
+  if(!path) {
+    fprintf(stderr, "usage: %s [-b baud] source [key=value ...]\n"
+                    "keys: sht21_interval, sgp30_interval (ms, only %d), resolution (12|11|10|8),\n"
+                    "      filter (0..%d), max_window (min), telemetry (off|readings),\n"
+                    "      divider, log_interval (min, 0 = off), screen (co2|temp|rh)\n", argv[0], CONFIG_SGP30_INTERVAL,
+            CONFIG_MAX_FILTER_SHIFT);
+    return 2;
+  }
+
+  int fd = openSerialPort(path, baud, O_RDWR);
+  if(fd < 0)
+    fd = openSerialPort(path, baud, O_RDONLY);
+  if(fd < 0) {
+    perror(path);
+    return 1;
+  }
+  bool device = isatty(fd);
+  if(!device && first < argc) {
+    fprintf(stderr, "%s: not a serial device, can't change the configuration\n", path);
+    return 2;
+  }
+
+  FrameScanner scanner;
+  ConfigBlock config;
+  uint8_t status;
+  uint8_t command[1 + CONFIG_BLOCK_SIZE] = {TELEMETRY_COMMAND_GET_CONFIG};
+
+  if(device) {
+    tcflush(fd, TCIFLUSH);
+    if(!sendCommand(fd, command, 1)) {
+      perror("write");
+      return 1;
+    }
+  }
+  if(!receiveConfig(fd, device, &scanner, &status, &config)) {
+    fprintf(stderr, "no configuration received\n");
+    return 1;
+  }
+
+  if(first < argc) {
+    if(config.version != CONFIG_VERSION) {
+      fprintf(stderr, "device uses config version %u, this tool %u\n", config.version, CONFIG_VERSION);
+      return 1;
+    }
+    for(int i = first; i < argc; i++) {
+      if(!set(&config, argv[i])) {
+        fprintf(stderr, "invalid setting: %s\n", argv[i]);
+        return 2;
+      }
+    }
+    command[0] = TELEMETRY_COMMAND_CONFIG;
+    memcpy(&command[1], &config, CONFIG_BLOCK_SIZE);
+    if(!sendCommand(fd, command, sizeof(command))) {
+      perror("write");
+      return 1;
+    }
+    if(!receiveConfig(fd, device, &scanner, &status, &config)) {
+      fprintf(stderr, "no answer, the configuration may not be stored\n");
+      return 1;
+    }
+    if(status != TELEMETRY_CONFIG_OK)
+      fprintf(stderr, "rejected by the device, the old configuration is active\n");
+  }
+  close(fd);
+
+  print(config);
+  return status == TELEMETRY_CONFIG_OK ? 0 : 1;
+}
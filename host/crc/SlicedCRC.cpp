@@ -0,0 +1,263 @@
+/*
+ * SlicedCRC.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <string.h>
+
+#include "SlicedCRC.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SLICEDCRC_X86
+#include <immintrin.h>
+#endif
+
+//***************************
+// Lookup tables
+//
+// slice[0]    the table of CRC::Init()
+// slice[k]    CRC of a byte followed by k zero bytes
+//
+// A word (b0, b1) with initial remainder 0xFF has the CRC
+//   slice[1][b0] ^ slice[0][b1] ^ slice[1][0xFF]
+// since the CRC is linear. Split into nibbles, each part
+// is a 16-entry table, which fits one pshufb.
+//***************************
+struct Tables {
+  uint8_t slice[8][256];
+  uint8_t first[256];         // slice[1][b0] ^ slice[1][INITIAL_REMAINDER]
+  uint8_t nibbles[4][16];     // slice[1] low/high, slice[0] low/high
+  uint8_t constant;
+  uint8_t deinterleave[3][3][16];   // [stream][source vector][byte]
+
+  Tables() {
+    for(unsigned int dividend = 0; dividend < 256; dividend++) {
+      uint8_t remainder = dividend;
+      for(uint8_t bit = 8; bit > 0; --bit) {
+        if(remainder & 0x80)
+          remainder = (remainder << 1) ^ POLYNOMIAL;
+        else
+          remainder = (remainder << 1);
+      }
+      slice[0][dividend] = remainder;
+    }
+    for(int k = 1; k < 8; k++) {
+      for(int i = 0; i < 256; i++) {
+        slice[k][i] = slice[0][slice[k - 1][i]];
+      }
+    }
+
+    constant = slice[1][INITIAL_REMAINDER];
+    for(int i = 0; i < 256; i++) {
+      first[i] = slice[1][i] ^ constant;
+    }
+    for(int n = 0; n < 16; n++) {
+      nibbles[0][n] = slice[1][n];
+      nibbles[1][n] = slice[1][n << 4];
+      nibbles[2][n] = slice[0][n];
+      nibbles[3][n] = slice[0][n << 4];
+    }
+
+    // Shuffle masks collecting byte s of every 3-byte word
+    // out of three consecutive 16-byte vectors
+    for(int s = 0; s < 3; s++) {
+      for(int v = 0; v < 3; v++) {
+        for(int i = 0; i < 16; i++) {
+          int source = SGP30_WORD_SIZE * i + s;
+          deinterleave[s][v][i] = (source / 16 == v) ? source % 16 : 0x80;
+        }
+      }
+    }
+  }
+};
+
+static const Tables &tables(void) {
+
+  static const Tables instance;
+  return instance;
+}
+
+//*********************************************************
+// CRC of a message, slicing-by-8
+//
+// input:   *message    data
+//          nBytes      count of bytes
+//          init        initial remainder
+//
+// return:  CRC, identical to CRC::Fast for the default init
+//*********************************************************
+uint8_t SlicedCRC::compute(const uint8_t *message, size_t nBytes, uint8_t init) {
+
+  const Tables &t = tables();
+  uint8_t remainder = init;
+
+  while(nBytes >= 8) {
+    remainder = t.slice[7][message[0] ^ remainder] ^ t.slice[6][message[1]] ^
+                t.slice[5][message[2]] ^ t.slice[4][message[3]] ^
+                t.slice[3][message[4]] ^ t.slice[2][message[5]] ^
+                t.slice[1][message[6]] ^ t.slice[0][message[7]];
+    message += 8;
+    nBytes -= 8;
+  }
+  while(nBytes--) {
+    remainder = t.slice[0][*message++ ^ remainder];
+  }
+  return remainder;
+}
+
+size_t SlicedCRC::verifyWordsScalar(const uint8_t *words, size_t count, uint8_t *valid) {
+
+  const Tables &t = tables();
+  size_t n = 0;
+
+  for(size_t i = 0; i < count; i++) {
+    const uint8_t *w = &words[SGP30_WORD_SIZE * i];
+    uint8_t ok = (t.first[w[0]] ^ t.slice[0][w[1]]) == w[2];
+    valid[i] = ok;
+    n += ok;
+  }
+  return n;
+}
+
+#if defined(SLICEDCRC_X86)
+
+__attribute__((target("ssse3")))
+size_t SlicedCRC::verifyWordsSSSE3(const uint8_t *words, size_t count, uint8_t *valid) {
+
+  const Tables &t = tables();
+  const __m128i low = _mm_set1_epi8(0x0F);
+  const __m128i one = _mm_set1_epi8(1);
+  const __m128i constant = _mm_set1_epi8(t.constant);
+  __m128i nibble[4], mask[3][3];
+  for(int k = 0; k < 4; k++) {
+    nibble[k] = _mm_loadu_si128((const __m128i *)t.nibbles[k]);
+  }
+  for(int s = 0; s < 3; s++) {
+    for(int v = 0; v < 3; v++) {
+      mask[s][v] = _mm_loadu_si128((const __m128i *)t.deinterleave[s][v]);
+    }
+  }
+
+  size_t n = 0, i = 0;
+  for(; i + 16 <= count; i += 16) {
+    const __m128i *p = (const __m128i *)&words[SGP30_WORD_SIZE * i];
+    __m128i v[3] = {_mm_loadu_si128(p), _mm_loadu_si128(p + 1), _mm_loadu_si128(p + 2)};
+    __m128i byte[3];
+    for(int s = 0; s < 3; s++) {
+      byte[s] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v[0], mask[s][0]),
+                                          _mm_shuffle_epi8(v[1], mask[s][1])),
+                             _mm_shuffle_epi8(v[2], mask[s][2]));
+    }
+
+    __m128i crc = _mm_xor_si128(constant,
+                  _mm_xor_si128(_mm_shuffle_epi8(nibble[0], _mm_and_si128(byte[0], low)),
+                                _mm_shuffle_epi8(nibble[1], _mm_and_si128(_mm_srli_epi16(byte[0], 4), low))));
+    crc = _mm_xor_si128(crc,
+          _mm_xor_si128(_mm_shuffle_epi8(nibble[2], _mm_and_si128(byte[1], low)),
+                        _mm_shuffle_epi8(nibble[3], _mm_and_si128(_mm_srli_epi16(byte[1], 4), low))));
+
+    __m128i equal = _mm_cmpeq_epi8(crc, byte[2]);
+    _mm_storeu_si128((__m128i *)&valid[i], _mm_and_si128(equal, one));
+    n += __builtin_popcount(_mm_movemask_epi8(equal));
+  }
+  return n + verifyWordsScalar(&words[SGP30_WORD_SIZE * i], count - i, &valid[i]);
+}
+
+__attribute__((target("avx2")))
+size_t SlicedCRC::verifyWordsAVX2(const uint8_t *words, size_t count, uint8_t *valid) {
+
+  const Tables &t = tables();
+  const __m256i low = _mm256_set1_epi8(0x0F);
+  const __m256i one = _mm256_set1_epi8(1);
+  const __m256i constant = _mm256_set1_epi8(t.constant);
+  __m256i nibble[4], mask[3][3];
+  for(int k = 0; k < 4; k++) {
+    nibble[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)t.nibbles[k]));
+  }
+  for(int s = 0; s < 3; s++) {
+    for(int v = 0; v < 3; v++) {
+      mask[s][v] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)t.deinterleave[s][v]));
+    }
+  }
+
+  size_t n = 0, i = 0;
+  for(; i + 32 <= count; i += 32) {
+    // Arrange words 0..15 in the low and 16..31 in the high lane
+    const __m256i *p = (const __m256i *)&words[SGP30_WORD_SIZE * i];
+    __m256i a = _mm256_loadu_si256(p);
+    __m256i b = _mm256_loadu_si256(p + 1);
+    __m256i c = _mm256_loadu_si256(p + 2);
+    __m256i v[3] = {_mm256_permute2x128_si256(a, b, 0x30),
+                    _mm256_permute2x128_si256(a, c, 0x21),
+                    _mm256_permute2x128_si256(b, c, 0x30)};
+    __m256i byte[3];
+    for(int s = 0; s < 3; s++) {
+      byte[s] = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(v[0], mask[s][0]),
+                                                _mm256_shuffle_epi8(v[1], mask[s][1])),
+                                _mm256_shuffle_epi8(v[2], mask[s][2]));
+    }
+
+    __m256i crc = _mm256_xor_si256(constant,
+                  _mm256_xor_si256(_mm256_shuffle_epi8(nibble[0], _mm256_and_si256(byte[0], low)),
+                                   _mm256_shuffle_epi8(nibble[1], _mm256_and_si256(_mm256_srli_epi16(byte[0], 4), low))));
+    crc = _mm256_xor_si256(crc,
+          _mm256_xor_si256(_mm256_shuffle_epi8(nibble[2], _mm256_and_si256(byte[1], low)),
+                           _mm256_shuffle_epi8(nibble[3], _mm256_and_si256(_mm256_srli_epi16(byte[1], 4), low))));
+
+    __m256i equal = _mm256_cmpeq_epi8(crc, byte[2]);
+    _mm256_storeu_si256((__m256i *)&valid[i], _mm256_and_si256(equal, one));
+    n += __builtin_popcount((unsigned int)_mm256_movemask_epi8(equal));
+  }
+  return n + verifyWordsSSSE3(&words[SGP30_WORD_SIZE * i], count - i, &valid[i]);
+}
+
+bool SlicedCRC::hasSSSE3(void) { return __builtin_cpu_supports("ssse3"); }
+bool SlicedCRC::hasAVX2(void) { return __builtin_cpu_supports("avx2"); }
+
+#else
+
+size_t SlicedCRC::verifyWordsSSSE3(const uint8_t *words, size_t count, uint8_t *valid) {
+  return verifyWordsScalar(words, count, valid);
+}
+
+size_t SlicedCRC::verifyWordsAVX2(const uint8_t *words, size_t count, uint8_t *valid) {
+  return verifyWordsScalar(words, count, valid);
+}
+
+bool SlicedCRC::hasSSSE3(void) { return false; }
+bool SlicedCRC::hasAVX2(void) { return false; }
+
+#endif
+
+//*********************************************************
+// Verify words with the fastest backend of this CPU
+//
+// input:   *words      count * 3 bytes (MSB, LSB, CRC)
+//          count       count of words
+//
+// output:  *valid      1 per correct word, 0 otherwise
+//
+// return:  count of correct words
+//*********************************************************
+size_t SlicedCRC::verifyWords(const uint8_t *words, size_t count, uint8_t *valid) {
+
+  static const bool avx2 = hasAVX2();
+  static const bool ssse3 = hasSSSE3();
+
+  if(avx2)
+    return verifyWordsAVX2(words, count, valid);
+  if(ssse3)
+    return verifyWordsSSSE3(words, count, valid);
+  return verifyWordsScalar(words, count, valid);
+}
+
+const char *SlicedCRC::backend(void) {
+
+  if(hasAVX2())
+    return "avx2";
+  if(hasSSSE3())
+    return "ssse3";
+  return "scalar";
+}
@@ -0,0 +1,50 @@
+/*
+ * SlicedCRC.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Host implementation of the CRC-8 in crc.h (poly 0x31,
+ * init 0xFF), bit-identical to CRC::Slow and CRC::Fast.
+ *
+ * compute()      slicing-by-8: one table lookup per byte, but
+ *                eight independent lookups per step instead of
+ *                a chain of dependent ones
+ * verifyWords()  checks many SGP30/SHT21-style words (2 data
+ *                bytes + CRC) at once. On x86 the words are
+ *                deinterleaved with SSSE3 shuffles and the CRC is
+ *                computed as XOR of four nibble table lookups
+ *                (pshufb), 16 words (SSSE3) or 32 words (AVX2)
+ *                per step.
+ */
+
+#ifndef SLICEDCRC_H_
+#define SLICEDCRC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crc.h"
+
+#if !defined(CRC8)
+#error "SlicedCRC requires the CRC8 standard in crc.h."
+#endif
+
+#define SGP30_WORD_SIZE   3       // 2 data bytes + CRC
+
+class SlicedCRC {
+  public:
+    static uint8_t compute(const uint8_t *message, size_t nBytes, uint8_t init = INITIAL_REMAINDER);
+
+    // valid[i] = 1 if word i has a correct CRC, return: count of valid words
+    static size_t verifyWords(const uint8_t *words, size_t count, uint8_t *valid);
+    static size_t verifyWordsScalar(const uint8_t *words, size_t count, uint8_t *valid);
+    static size_t verifyWordsSSSE3(const uint8_t *words, size_t count, uint8_t *valid);
+    static size_t verifyWordsAVX2(const uint8_t *words, size_t count, uint8_t *valid);
+
+    static bool hasSSSE3(void);
+    static bool hasAVX2(void);
+    static const char *backend(void);
+};
+
+#endif /* SLICEDCRC_H_ */
@@ -0,0 +1,134 @@
+/*
+ * crc_bench.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Compares the host CRC backends with CRC::Slow and CRC::Fast
+ * of the firmware and checks that all results are identical.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/crc -I. -o lp_crc_bench host/crc/crc_bench.cpp host/crc/SlicedCRC.cpp crc.cpp
+ *
+ * Usage:
+ *   lp_crc_bench [words]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "crc.h"
+#include "SlicedCRC.h"
+#include "Telemetry.h"
+
+// Object of CRC calculation
+CRC crc;
+
+static double now(void) {
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool report(const char *name, double seconds, size_t items, const char *unit,
+                   const std::vector<uint8_t> &result, const std::vector<uint8_t> &reference) {
+
+  bool same = (result == reference);
+  printf("  %-16s %8.2f M%s/s  %s\n", name, items / seconds / 1e6, unit, same ? "ok" : "MISMATCH");
+  return same;
+}
+
+int main(int argc, char **argv) {
+
+  size_t words = argc > 1 ? strtoul(argv[1], 0, 10) : (16UL << 20);
+  bool ok = true;
+
+  crc.Init();
+  std::mt19937 random(1);
+
+  // SGP30 words, about 1% with a wrong checksum
+  std::vector<uint8_t> data(words * SGP30_WORD_SIZE);
+  for(size_t i = 0; i < words; i++) {
+    uint8_t *w = &data[SGP30_WORD_SIZE * i];
+    w[0] = random();
+    w[1] = random();
+    w[2] = crc.Fast(w, 2);
+    if(random() % 100 == 0)
+      w[2] ^= 1 << (random() % 8);
+  }
+
+  printf("SGP30 words: %lu (backend %s)\n", (unsigned long)words, SlicedCRC::backend());
+
+  std::vector<uint8_t> reference(words), result(words);
+  double start = now();
+  for(size_t i = 0; i < words; i++) {
+    reference[i] = crc.Slow(&data[SGP30_WORD_SIZE * i], 2) == data[SGP30_WORD_SIZE * i + 2];
+  }
+  report("CRC::Slow", now() - start, words, "words", reference, reference);
+
+  start = now();
+  for(size_t i = 0; i < words; i++) {
+    result[i] = crc.Fast(&data[SGP30_WORD_SIZE * i], 2) == data[SGP30_WORD_SIZE * i + 2];
+  }
+  ok &= report("CRC::Fast", now() - start, words, "words", result, reference);
+
+  start = now();
+  SlicedCRC::verifyWordsScalar(&data[0], words, &result[0]);
+  ok &= report("batch scalar", now() - start, words, "words", result, reference);
+
+  if(SlicedCRC::hasSSSE3()) {
+    memset(&result[0], 0xAA, words);
+    start = now();
+    SlicedCRC::verifyWordsSSSE3(&data[0], words, &result[0]);
+    ok &= report("batch ssse3", now() - start, words, "words", result, reference);
+  }
+  if(SlicedCRC::hasAVX2()) {
+    memset(&result[0], 0xAA, words);
+    start = now();
+    SlicedCRC::verifyWordsAVX2(&data[0], words, &result[0]);
+    ok &= report("batch avx2", now() - start, words, "words", result, reference);
+  }
+
+  // Complete telemetry frames: CRC over type, length and payload
+  size_t frames = words / 8;
+  size_t frameLength = TELEMETRY_READING_SIZE + 2;
+  std::vector<uint8_t> frameData(frames * frameLength);
+  for(size_t i = 0; i < frameData.size(); i++) {
+    frameData[i] = random();
+  }
+  printf("frames: %lu x %lu bytes\n", (unsigned long)frames, (unsigned long)frameLength);
+
+  std::vector<uint8_t> frameReference(frames), frameResult(frames);
+  start = now();
+  for(size_t i = 0; i < frames; i++) {
+    frameReference[i] = crc.Slow(&frameData[i * frameLength], frameLength);
+  }
+  report("CRC::Slow", now() - start, frames, "frames", frameReference, frameReference);
+
+  start = now();
+  for(size_t i = 0; i < frames; i++) {
+    frameResult[i] = crc.Fast(&frameData[i * frameLength], frameLength);
+  }
+  ok &= report("CRC::Fast", now() - start, frames, "frames", frameResult, frameReference);
+
+  start = now();
+  for(size_t i = 0; i < frames; i++) {
+    frameResult[i] = SlicedCRC::compute(&frameData[i * frameLength], frameLength);
+  }
+  ok &= report("slicing-by-8", now() - start, frames, "frames", frameResult, frameReference);
+
+  // One long message
+  std::vector<uint8_t> single(1), singleReference(1);
+  start = now();
+  singleReference[0] = crc.Fast(&data[0], data.size());
+  report("CRC::Fast", now() - start, data.size(), "B", singleReference, singleReference);
+  start = now();
+  single[0] = SlicedCRC::compute(&data[0], data.size());
+  ok &= report("slicing-by-8", now() - start, data.size(), "B", single, singleReference);
+
+  printf(ok ? "all results identical\n" : "RESULTS DIFFER\n");
+  return ok ? 0 : 1;
+}
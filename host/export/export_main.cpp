@@ -0,0 +1,203 @@
+/*
+ * export_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Fetches the measurement log (see RecordLog.h) and writes
+ * it as CSV. The device sends the records at the export
+ * baud rate while it keeps measuring. Blocks lost to a
+ * wrong CRC or a timeout are requested again from the
+ * first missing record on. Times are calculated from the
+ * age of the newest record and the log interval.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/shim -Ihost/common -Ihost/crc -I. -o lp_export \
+ *       host/export/export_main.cpp host/common/FrameScanner.cpp host/common/SerialPort.cpp \
+ *       host/crc/SlicedCRC.cpp
+ *
+ * Usage:
+ *   lp_export [-b baud] [-x export baud] [-f first] [-n count] [-o out.csv] source
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <map>
+
+#include "FrameScanner.h"
+#include "RecordLog.h"
+#include "SerialPort.h"
+#include "SlicedCRC.h"
+#include "Telemetry.h"
+
+#define BLOCK_TIMEOUT     2000      // ms, the first block comes after LOG_SWITCH_TIME
+#define MAX_RETRIES       5
+
+struct Record {
+  long long time;         // ms since 1970
+  uint16_t co2;
+  uint16_t tvoc;
+  int16_t temperature;
+  uint16_t humidity;
+};
+
+static const unsigned long baudRates[LOG_BAUD_COUNT] = {9600, 19200, 38400, 57600, 115200};
+
+static long long now(void) {
+
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static bool sendExportCommand(int fd, uint32_t first, uint16_t count, uint8_t baud) {
+
+  uint8_t frame[TELEMETRY_OVERHEAD + 8] = {TELEMETRY_SYNC, TELEMETRY_FRAME_COMMAND, 8,
+                                           TELEMETRY_COMMAND_EXPORT,
+                                           (uint8_t)first, (uint8_t)(first >> 8),
+                                           (uint8_t)(first >> 16), (uint8_t)(first >> 24),
+                                           (uint8_t)count, (uint8_t)(count >> 8), baud, 0};
+  frame[sizeof(frame) - 1] = SlicedCRC::compute(&frame[1], sizeof(frame) - 2);
+  return write(fd, frame, sizeof(frame)) == (ssize_t)sizeof(frame);
+}
+
+int main(int argc, char **argv) {
+
+  unsigned long baud = 9600;
+  unsigned long exportBaud = 115200;
+  unsigned long first = 0;
+  unsigned long count = 0xFFFF;
+  const char *outputPath = "-";
+  const char *path = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-b") && i + 1 < argc) baud = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-x") && i + 1 < argc) exportBaud = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-f") && i + 1 < argc) first = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-n") && i + 1 < argc) count = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-o") && i + 1 < argc) outputPath = argv[++i];
+    else path = argv[i];
+  }
+  int baudCode = -1;
+  for(int i = 0; i < LOG_BAUD_COUNT; i++) {
+    if(baudRates[i] == exportBaud)
+      baudCode = i;
+  }
+  if(!path || baudCode < 0 || count == 0 || count > 0xFFFF) {
+    fprintf(stderr, "usage: %s [-b baud] [-x export baud (9600..115200)] [-f first] [-n count] [-o out.csv] source\n", argv[0]);
+    return 2;
+  }
+
+  int fd = openSerialPort(path, baud, O_RDWR);
+  if(fd < 0)
+    fd = openSerialPort(path, baud, O_RDONLY);
+  if(fd < 0) {
+    perror(path);
+    return 1;
+  }
+  bool device = isatty(fd);
+
+  FrameScanner scanner;
+  Frame frame;
+  std::map<uint32_t, Record> records;
+  unsigned long end = count == 0xFFFF ? 0xFFFFFFFFUL : first + count;
+  unsigned long next = first;   // first record not received yet
+  unsigned long total = 0;
+  int retries = 0;
+  bool done = false;
+  long long startTime = now();
+
+  while(!done) {
+    if(device) {
+      tcflush(fd, TCIFLUSH);
+      uint16_t n = count == 0xFFFF ? 0xFFFF : end - next;
+      if(!sendExportCommand(fd, next, n, baudCode) || !setSerialBaud(fd, exportBaud)) {
+        perror("write");
+        return 1;
+      }
+    }
+
+    // One pass, ends with the empty block or a timeout
+    unsigned long expected = next;
+    unsigned long missing = 0xFFFFFFFFUL;
+    bool complete = false;
+    while(!complete) {
+      if(device) {
+        struct pollfd p = {fd, POLLIN, 0};
+        if(poll(&p, 1, BLOCK_TIMEOUT) <= 0)
+          break;
+      }
+      uint8_t buffer[4096];
+      ssize_t length = read(fd, buffer, sizeof(buffer));
+      if(length <= 0)
+        break;
+      scanner.feed(buffer, length);
+      long long received = now();
+
+      while(scanner.next(&frame)) {
+        if(frame.type != TELEMETRY_FRAME_EXPORT || frame.length < LOG_BLOCK_HEADER)
+          continue;
+        uint32_t index = getUInt32(frame.payload);
+        total = getUInt32(frame.payload + 4);
+        uint32_t age = getUInt32(frame.payload + 8);
+        uint8_t interval = frame.payload[12];
+        int n = (frame.length - LOG_BLOCK_HEADER) / sizeof(LogRecord);
+        uint32_t oldest = total > LOG_MAX_RECORDS ? total - LOG_MAX_RECORDS : 0;
+
+        // A block in between got lost (overwritten ones are gone)
+        if(index > expected && index > oldest && missing > (expected > oldest ? expected : oldest))
+          missing = expected > oldest ? expected : oldest;
+        const uint8_t *p = frame.payload + LOG_BLOCK_HEADER;
+        for(int i = 0; i < n; i++) {
+          Record r;
+          r.time = received - age - (long long)(total - 1 - (index + i)) * interval * 60000;
+          r.co2 = getUInt16(p);
+          r.tvoc = getUInt16(p + 2);
+          r.temperature = (int16_t)getUInt16(p + 4);
+          r.humidity = getUInt16(p + 6);
+          records[index + i] = r;
+          p += sizeof(LogRecord);
+        }
+        expected = index + n;
+        if(n == 0)
+          complete = true;
+      }
+    }
+    if(device)
+      setSerialBaud(fd, baud);
+
+    if(complete && missing == 0xFFFFFFFFUL)
+      done = true;
+    else if(!device || ++retries > MAX_RETRIES)
+      break;
+    else {
+      next = complete ? missing : expected;
+      fprintf(stderr, "resuming at record %lu\n", next);
+    }
+  }
+  close(fd);
+
+  FILE *output = strcmp(outputPath, "-") ? fopen(outputPath, "w") : stdout;
+  if(!output) {
+    perror(outputPath);
+    return 1;
+  }
+  fprintf(output, "index,time_ms,co2,tvoc,temperature,humidity\n");
+  for(std::map<uint32_t, Record>::const_iterator i = records.begin(); i != records.end(); ++i) {
+    const Record &r = i->second;
+    fprintf(output, "%u,%lld,%u,%u,%d,%u\n", i->first, r.time, r.co2, r.tvoc, r.temperature, r.humidity);
+  }
+  if(output != stdout)
+    fclose(output);
+
+  double seconds = (now() - startTime) / 1000.0;
+  fprintf(stderr, "%u records (%lu written on the device), %d retries, %lu bad frames, %.2f s\n",
+          (unsigned int)records.size(), total, retries, (unsigned long)scanner.framesBadCRC, seconds);
+  return done ? 0 : 1;
+}
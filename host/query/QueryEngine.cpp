@@ -0,0 +1,395 @@
+/*
+ * QueryEngine.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <thread>
+#include <utility>
+
+#include "QueryEngine.h"
+
+#define QUERY_BATCH_CHUNKS    16      // chunks a worker takes at once
+
+typedef std::pair<uint32_t, int64_t> GroupKey;
+
+Query::Query()
+  : channel(TS_CO2), from(std::numeric_limits<int64_t>::min()), to(std::numeric_limits<int64_t>::max()),
+    anyDevice(true), device(0), filter(-1), filterMin(std::numeric_limits<int32_t>::min()),
+    filterMax(std::numeric_limits<int32_t>::max()), window(0), byDevice(false), minDuration(0), maxGap(0) {
+}
+
+QueryResult::QueryResult()
+  : chunksSkipped(0), chunksIndexed(0), chunksDecoded(0), samplesScanned(0) {
+}
+
+//***************************
+// State of one thread: decoded columns and partial results
+//***************************
+struct QueryEngine::Worker {
+  std::vector<int64_t> timestamps;
+  std::vector<int32_t> values;
+  std::vector<int32_t> filterValues;
+  std::vector<uint64_t> mask;
+  std::map<GroupKey, ChannelStats> groups;
+  std::vector<QueryRun> runs;
+  uint64_t chunksIndexed;
+  uint64_t chunksDecoded;
+  uint64_t samplesScanned;
+  // Consecutive windows of a chunk hit the same group
+  GroupKey lastKey;
+  ChannelStats *lastGroup;
+
+  Worker() : chunksIndexed(0), chunksDecoded(0), samplesScanned(0), lastGroup(0) {}
+
+  ChannelStats &group(uint32_t device, int64_t window) {
+    GroupKey key(device, window);
+    if(!lastGroup || key != lastKey) {
+      lastKey = key;
+      lastGroup = &groups[key];
+    }
+    return *lastGroup;
+  }
+
+  void resize(uint32_t count) {
+    timestamps.resize(count);
+    values.resize(count);
+    filterValues.resize(count);
+    mask.resize((count + 63) / 64);
+  }
+};
+
+// Start of the window of a timestamp, aligned to 1970
+static int64_t windowOf(const Query &query, int64_t time) {
+
+  if(query.window <= 0)
+    return 0;
+  int64_t n = time / query.window;
+  if(time % query.window < 0)
+    n--;
+  return n * query.window;
+}
+
+// First index >= from whose bit equals value, count if none
+static size_t findBit(const uint64_t *mask, size_t count, size_t from, bool value) {
+
+  while(from < count) {
+    uint64_t word = value ? mask[from / 64] : ~mask[from / 64];
+    word >>= from % 64;
+    if(word) {
+      size_t at = from + __builtin_ctzll(word);
+      return at < count ? at : count;
+    }
+    from = (from / 64 + 1) * 64;
+  }
+  return count;
+}
+
+static ChannelStats indexStats(const ChunkHeader &header, int c) {
+
+  ChannelStats stats;
+  stats.count = header.count;
+  stats.sum = header.channels[c].sum;
+  stats.min = header.channels[c].min;
+  stats.max = header.channels[c].max;
+  return stats;
+}
+
+QueryEngine::QueryEngine(const TimeSeriesReader &file, unsigned int threadCount)
+  : reader(file), threads(1), kernels(&QueryKernels::best()) {
+
+  std::map<uint32_t, std::vector<uint32_t> > chunks;
+  for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+    chunks[reader.chunkRef(i).device].push_back(i);
+  }
+  for(std::map<uint32_t, std::vector<uint32_t> >::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+    std::vector<uint32_t> &list = it->second;
+    std::stable_sort(list.begin(), list.end(), [this](uint32_t a, uint32_t b) {
+      return reader.chunkRef(a).timeMin < reader.chunkRef(b).timeMin;
+    });
+    // Sample interval: the smallest mean interval of a chunk,
+    // outages only make it larger
+    int64_t interval = 0;
+    for(size_t k = 0; k < list.size(); k++) {
+      const ChunkRef &ref = reader.chunkRef(list[k]);
+      uint32_t count = reader.chunk(list[k]).count;
+      if(count < 2)
+        continue;
+      int64_t mean = (ref.timeMax - ref.timeMin) / (count - 1);
+      if(interval == 0 || mean < interval)
+        interval = mean;
+    }
+    devices.push_back(it->first);
+    deviceChunks.push_back(list);
+    deviceIntervals.push_back(interval);
+  }
+  setThreads(threadCount);
+}
+
+// 0 = one thread per core
+void QueryEngine::setThreads(unsigned int threadCount) {
+
+  threads = threadCount ? threadCount : std::thread::hardware_concurrency();
+  if(threads == 0)
+    threads = 1;
+}
+
+void QueryEngine::setKernels(const QueryKernels &backend) {
+
+  kernels = &backend;
+}
+
+// Device and time range of the chunk overlap the query
+bool QueryEngine::selected(const Query &query, uint32_t chunk) const {
+
+  const ChunkRef &ref = reader.chunkRef(chunk);
+  return (query.anyDevice || ref.device == query.device) && ref.timeMax >= query.from && ref.timeMin <= query.to;
+}
+
+//*********************************************************
+// Add the samples of a chunk to the groups of a worker
+//*********************************************************
+void QueryEngine::aggregateChunk(const Query &query, uint32_t chunk, Worker *worker) const {
+
+  const ChunkRef &ref = reader.chunkRef(chunk);
+  const ChunkHeader &header = reader.chunk(chunk);
+  uint32_t device = query.byDevice ? ref.device : 0;
+  bool all = true;
+
+  if(query.filter >= 0) {
+    const ChannelIndex &f = header.channels[query.filter];
+    if(f.max < query.filterMin || f.min > query.filterMax)
+      return;
+    all = f.min >= query.filterMin && f.max <= query.filterMax;
+  }
+  if(all && ref.timeMin >= query.from && ref.timeMax <= query.to &&
+     windowOf(query, ref.timeMin) == windowOf(query, ref.timeMax)) {
+    worker->group(device, windowOf(query, ref.timeMin)).add(indexStats(header, query.channel));
+    worker->chunksIndexed++;
+    return;
+  }
+
+  worker->resize(header.count);
+  int64_t *t = &worker->timestamps[0];
+  int32_t *values = &worker->values[0];
+  const int32_t *filter = values;
+  reader.decodeTime(chunk, t);
+  reader.decodeChannel(chunk, query.channel, values);
+  if(query.filter >= 0 && query.filter != query.channel) {
+    reader.decodeChannel(chunk, query.filter, &worker->filterValues[0]);
+    filter = &worker->filterValues[0];
+  }
+  worker->chunksDecoded++;
+
+  // Samples are in time order
+  size_t lo = std::lower_bound(t, t + header.count, query.from) - t;
+  size_t hi = std::upper_bound(t, t + header.count, query.to) - t;
+  worker->samplesScanned += hi - lo;
+  while(lo < hi) {
+    int64_t window = windowOf(query, t[lo]);
+    size_t end = query.window > 0 ? std::upper_bound(t + lo, t + hi, window + query.window - 1) - t : hi;
+    ChannelStats &stats = worker->group(device, window);
+    if(query.filter >= 0)
+      kernels->aggregateFiltered(&values[lo], &filter[lo], end - lo, query.filterMin, query.filterMax, &stats);
+    else
+      kernels->aggregate(&values[lo], end - lo, &stats);
+    lo = end;
+  }
+}
+
+// No two consecutive samples further apart than gap
+static bool gapless(const int64_t *t, size_t count, int64_t gap) {
+
+  bool ok = true;
+  for(size_t i = 1; i < count; i++) {
+    ok &= t[i] - t[i - 1] <= gap;
+  }
+  return ok;
+}
+
+static void closeRun(const Query &query, const QueryRun &run, bool *open, std::vector<QueryRun> *runs) {
+
+  if(*open && run.end - run.start >= query.minDuration)
+    runs->push_back(run);
+  *open = false;
+}
+
+//*********************************************************
+// Find the runs of a device, its chunks in time order
+// A run ends with the first sample outside the filter or
+// where two samples are further apart than the gap. A chunk
+// matching completely is taken from the index only if its
+// timestamps have no gap.
+//*********************************************************
+void QueryEngine::runsOfDevice(const Query &query, size_t device, Worker *worker) const {
+
+  int filterChannel = query.filter >= 0 ? query.filter : query.channel;
+  int64_t gap = query.maxGap > 0 ? query.maxGap : QUERY_GAP_INTERVALS * deviceIntervals[device];
+  QueryRun run;
+  bool open = false;
+
+  if(gap <= 0)
+    gap = std::numeric_limits<int64_t>::max();
+  run.device = devices[device];
+  for(size_t k = 0; k < deviceChunks[device].size(); k++) {
+    uint32_t chunk = deviceChunks[device][k];
+    const ChunkRef &ref = reader.chunkRef(chunk);
+    if(ref.timeMax < query.from || ref.timeMin > query.to)
+      continue;
+
+    const ChunkHeader &header = reader.chunk(chunk);
+    const ChannelIndex &f = header.channels[filterChannel];
+    if(f.max < query.filterMin || f.min > query.filterMax) {
+      closeRun(query, run, &open, &worker->runs);
+      continue;
+    }
+
+    worker->resize(header.count);
+    int64_t *t = &worker->timestamps[0];
+    reader.decodeTime(chunk, t);
+    if(f.min >= query.filterMin && f.max <= query.filterMax && ref.timeMin >= query.from && ref.timeMax <= query.to &&
+       gapless(t, header.count, gap)) {
+      if(open && ref.timeMin - run.end > gap)
+        closeRun(query, run, &open, &worker->runs);
+      if(!open) {
+        run.start = ref.timeMin;
+        run.stats = ChannelStats();
+        open = true;
+      }
+      run.end = ref.timeMax;
+      run.stats.add(indexStats(header, query.channel));
+      worker->chunksIndexed++;
+      continue;
+    }
+
+    int32_t *values = &worker->values[0];
+    const int32_t *filter = values;
+    reader.decodeChannel(chunk, query.channel, values);
+    if(filterChannel != query.channel) {
+      reader.decodeChannel(chunk, filterChannel, &worker->filterValues[0]);
+      filter = &worker->filterValues[0];
+    }
+    worker->chunksDecoded++;
+
+    size_t lo = std::lower_bound(t, t + header.count, query.from) - t;
+    size_t hi = std::upper_bound(t, t + header.count, query.to) - t;
+    size_t n = hi - lo;
+    const uint64_t *mask = &worker->mask[0];
+    worker->samplesScanned += n;
+    kernels->match(&filter[lo], n, query.filterMin, query.filterMax, &worker->mask[0]);
+
+    for(size_t position = 0; position < n; ) {
+      size_t a = findBit(mask, n, position, true);
+      if(a > position)
+        closeRun(query, run, &open, &worker->runs);
+      if(a >= n)
+        break;
+      size_t b = findBit(mask, n, a, false);
+      // Split the matching samples at the gaps
+      for(size_t i = a; i < b; ) {
+        if(open && t[lo + i] - run.end > gap)
+          closeRun(query, run, &open, &worker->runs);
+        size_t j = i + 1;
+        while(j < b && t[lo + j] - t[lo + j - 1] <= gap) {
+          j++;
+        }
+        if(!open) {
+          run.start = t[lo + i];
+          run.stats = ChannelStats();
+          open = true;
+        }
+        run.end = t[lo + j - 1];
+        kernels->aggregate(&values[lo + i], j - i, &run.stats);
+        i = j;
+      }
+      position = b;
+    }
+  }
+  closeRun(query, run, &open, &worker->runs);
+}
+
+//*********************************************************
+// Run a query on all threads
+//
+// input:   query       see Query
+//
+// return:  groups, or runs if query.minDuration > 0
+//*********************************************************
+QueryResult QueryEngine::run(const Query &query) const {
+
+  QueryResult result;
+  std::vector<Worker> workers(threads);
+  std::vector<uint32_t> items;
+  std::atomic<size_t> next(0);
+  bool runs = query.minDuration > 0;
+  size_t batch = runs ? 1 : QUERY_BATCH_CHUNKS;
+
+  // Work items: devices for runs, selected chunks otherwise
+  if(runs) {
+    for(size_t d = 0; d < devices.size(); d++) {
+      if(query.anyDevice || devices[d] == query.device)
+        items.push_back(d);
+    }
+  }
+  else {
+    for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+      if(selected(query, i))
+        items.push_back(i);
+    }
+  }
+
+  auto work = [&](Worker *worker) {
+    for(;;) {
+      size_t first = next.fetch_add(batch);
+      if(first >= items.size())
+        break;
+      size_t last = std::min(first + batch, items.size());
+      for(size_t i = first; i < last; i++) {
+        if(runs)
+          runsOfDevice(query, items[i], worker);
+        else
+          aggregateChunk(query, items[i], worker);
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for(unsigned int k = 1; k < threads; k++) {
+    pool.push_back(std::thread(work, &workers[k]));
+  }
+  work(&workers[0]);
+  for(size_t k = 0; k < pool.size(); k++) {
+    pool[k].join();
+  }
+
+  std::map<GroupKey, ChannelStats> groups;
+  for(size_t k = 0; k < workers.size(); k++) {
+    const Worker &w = workers[k];
+    for(std::map<GroupKey, ChannelStats>::const_iterator it = w.groups.begin(); it != w.groups.end(); ++it) {
+      groups[it->first].add(it->second);
+    }
+    result.runs.insert(result.runs.end(), w.runs.begin(), w.runs.end());
+    result.chunksIndexed += w.chunksIndexed;
+    result.chunksDecoded += w.chunksDecoded;
+    result.samplesScanned += w.samplesScanned;
+  }
+  for(std::map<GroupKey, ChannelStats>::const_iterator it = groups.begin(); it != groups.end(); ++it) {
+    // Decoded windows without a matching sample
+    if(it->second.count == 0)
+      continue;
+    QueryGroup group;
+    group.device = it->first.first;
+    group.window = it->first.second;
+    group.stats = it->second;
+    result.groups.push_back(group);
+  }
+  std::sort(result.runs.begin(), result.runs.end(), [](const QueryRun &a, const QueryRun &b) {
+    return a.device != b.device ? a.device < b.device : a.start < b.start;
+  });
+  result.chunksSkipped = reader.chunkCount() - result.chunksIndexed - result.chunksDecoded;
+  return result;
+}
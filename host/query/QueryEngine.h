@@ -0,0 +1,113 @@
+/*
+ * QueryEngine.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Filter, group-by and window aggregates over .lpts files (see
+ * TimeSeriesFile.h), e.g.
+ *
+ *   hourly mean temperature per device
+ *     channel temperature, window 1 h, byDevice
+ *   devices above 1000 ppm CO2 for more than 30 minutes
+ *     filter co2 >= 1000, minDuration 30 min
+ *
+ * A run ends with the first sample outside the filter or
+ * with a gap in the data (maxGap), so an outage isn't taken
+ * for a long run.
+ *
+ * Aggregates are split into batches of chunks, runs into
+ * devices, both taken by a pool of threads. The chunk index
+ * decides before decoding:
+ *
+ *   skipped   device, time or filter range don't overlap
+ *   index     the chunk lies in one window and matches the
+ *             filter completely, count/sum/min/max are taken
+ *             from the index (a run is extended over it if
+ *             its timestamps have no gap)
+ *   decoded   the columns are decoded and reduced with
+ *             QueryKernels
+ */
+
+#ifndef QUERYENGINE_H_
+#define QUERYENGINE_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "TimeSeriesFile.h"
+#include "QueryKernels.h"
+
+#define QUERY_GAP_INTERVALS   3     // default maxGap in sample intervals
+
+struct Query {
+  int channel;                  // aggregated channel (TS_xxx)
+  int64_t from;                 // ms since 1970, inclusive
+  int64_t to;
+  bool anyDevice;               // false to select a single device
+  uint32_t device;
+  int filter;                   // channel of the filter, -1 = none
+  int32_t filterMin;            // samples with filterMin <= value <= filterMax
+  int32_t filterMax;
+  int64_t window;               // ms, aligned to 1970, 0 = whole range
+  bool byDevice;                // one group per device
+  int64_t minDuration;          // ms, > 0: runs of filtered samples instead of groups
+  int64_t maxGap;               // ms between two samples of a run, 0 = QUERY_GAP_INTERVALS
+                                // sample intervals of the device
+
+  Query();
+};
+
+// Aggregate of a device (0 without byDevice) and window
+struct QueryGroup {
+  uint32_t device;
+  int64_t window;               // start in ms, 0 without a window
+  ChannelStats stats;
+};
+
+// Consecutive samples of a device matching the filter,
+// no further apart than maxGap
+struct QueryRun {
+  uint32_t device;
+  int64_t start;                // timestamps of the first and
+  int64_t end;                  // the last sample
+  ChannelStats stats;           // of the aggregated channel
+};
+
+struct QueryResult {
+  std::vector<QueryGroup> groups;   // sorted by device and window
+  std::vector<QueryRun> runs;       // sorted by device and start
+  uint64_t chunksSkipped;
+  uint64_t chunksIndexed;
+  uint64_t chunksDecoded;
+  uint64_t samplesScanned;          // decoded samples
+
+  QueryResult();
+};
+
+//***************************
+// Runs queries on an open file
+//***************************
+class QueryEngine {
+  private:
+    const TimeSeriesReader &reader;
+    unsigned int threads;
+    const QueryKernels *kernels;
+    std::vector<uint32_t> devices;
+    std::vector<std::vector<uint32_t> > deviceChunks;   // in time order
+    std::vector<int64_t> deviceIntervals;               // ms between samples, 0 = unknown
+    struct Worker;
+    bool selected(const Query &query, uint32_t chunk) const;
+    void aggregateChunk(const Query &query, uint32_t chunk, Worker *worker) const;
+    void runsOfDevice(const Query &query, size_t device, Worker *worker) const;
+
+  public:
+    explicit QueryEngine(const TimeSeriesReader &file, unsigned int threadCount = 0);
+    void setThreads(unsigned int threadCount);
+    void setKernels(const QueryKernels &backend);
+    unsigned int getThreads(void) const { return threads; }
+    const QueryKernels &getKernels(void) const { return *kernels; }
+    QueryResult run(const Query &query) const;
+};
+
+#endif /* QUERYENGINE_H_ */
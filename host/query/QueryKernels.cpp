@@ -0,0 +1,181 @@
+/*
+ * QueryKernels.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <string.h>
+
+#include "QueryKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define QUERYKERNELS_X86
+#include <immintrin.h>
+#endif
+
+//***************************
+// Scalar backend
+//***************************
+static void aggregateScalar(const int32_t *values, size_t count, ChannelStats *stats) {
+
+  for(size_t i = 0; i < count; i++) {
+    stats->add(values[i]);
+  }
+}
+
+static void aggregateFilteredScalar(const int32_t *values, const int32_t *filter, size_t count,
+                                    int32_t low, int32_t high, ChannelStats *stats) {
+
+  for(size_t i = 0; i < count; i++) {
+    if(filter[i] >= low && filter[i] <= high)
+      stats->add(values[i]);
+  }
+}
+
+static size_t matchScalar(const int32_t *filter, size_t count, int32_t low, int32_t high, uint64_t *mask) {
+
+  size_t n = 0;
+
+  memset(mask, 0, (count + 63) / 64 * sizeof(uint64_t));
+  for(size_t i = 0; i < count; i++) {
+    uint64_t bit = filter[i] >= low && filter[i] <= high;
+    mask[i / 64] |= bit << (i % 64);
+    n += bit;
+  }
+  return n;
+}
+
+#if defined(QUERYKERNELS_X86)
+
+//***************************
+// AVX2 backend
+//
+// Lanes outside the filter add 0 to the sum and the
+// neutral element to min and max.
+//***************************
+__attribute__((target("avx2")))
+static void reduce(__m256i sum, __m256i minimum, __m256i maximum, uint64_t count, ChannelStats *stats) {
+
+  int32_t s[8], lo[8], hi[8];
+  ChannelStats part;
+
+  _mm256_storeu_si256((__m256i *)s, sum);
+  _mm256_storeu_si256((__m256i *)lo, minimum);
+  _mm256_storeu_si256((__m256i *)hi, maximum);
+  part.count = count;
+  for(int k = 0; k < 8; k++) {
+    part.sum += s[k];
+    if(lo[k] < part.min) part.min = lo[k];
+    if(hi[k] > part.max) part.max = hi[k];
+  }
+  stats->add(part);
+}
+
+__attribute__((target("avx2")))
+static void aggregateAVX2(const int32_t *values, size_t count, ChannelStats *stats) {
+
+  size_t i = 0;
+
+  while(i + 8 <= count) {
+    __m256i sum = _mm256_setzero_si256();
+    __m256i minimum = _mm256_set1_epi32(INT32_MAX);
+    __m256i maximum = _mm256_set1_epi32(INT32_MIN);
+    size_t start = i;
+    for(int step = 0; step < QUERY_LANE_BLOCK && i + 8 <= count; step++, i += 8) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)&values[i]);
+      sum = _mm256_add_epi32(sum, v);
+      minimum = _mm256_min_epi32(minimum, v);
+      maximum = _mm256_max_epi32(maximum, v);
+    }
+    reduce(sum, minimum, maximum, i - start, stats);
+  }
+  aggregateScalar(&values[i], count - i, stats);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i inside(__m256i f, __m256i low, __m256i high) {
+
+  return _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(low, f), _mm256_cmpgt_epi32(f, high)),
+                             _mm256_set1_epi32(-1));
+}
+
+__attribute__((target("avx2")))
+static void aggregateFilteredAVX2(const int32_t *values, const int32_t *filter, size_t count,
+                                  int32_t low, int32_t high, ChannelStats *stats) {
+
+  const __m256i lowest = _mm256_set1_epi32(INT32_MAX);
+  const __m256i highest = _mm256_set1_epi32(INT32_MIN);
+  const __m256i l = _mm256_set1_epi32(low);
+  const __m256i h = _mm256_set1_epi32(high);
+  size_t i = 0;
+
+  while(i + 8 <= count) {
+    __m256i sum = _mm256_setzero_si256();
+    __m256i minimum = lowest;
+    __m256i maximum = highest;
+    uint64_t n = 0;
+    for(int step = 0; step < QUERY_LANE_BLOCK && i + 8 <= count; step++, i += 8) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)&values[i]);
+      __m256i in = inside(_mm256_loadu_si256((const __m256i *)&filter[i]), l, h);
+      sum = _mm256_add_epi32(sum, _mm256_and_si256(in, v));
+      minimum = _mm256_min_epi32(minimum, _mm256_blendv_epi8(lowest, v, in));
+      maximum = _mm256_max_epi32(maximum, _mm256_blendv_epi8(highest, v, in));
+      n += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(in)));
+    }
+    reduce(sum, minimum, maximum, n, stats);
+  }
+  aggregateFilteredScalar(&values[i], &filter[i], count - i, low, high, stats);
+}
+
+__attribute__((target("avx2")))
+static size_t matchAVX2(const int32_t *filter, size_t count, int32_t low, int32_t high, uint64_t *mask) {
+
+  const __m256i l = _mm256_set1_epi32(low);
+  const __m256i h = _mm256_set1_epi32(high);
+  size_t n = 0, i = 0;
+
+  memset(mask, 0, (count + 63) / 64 * sizeof(uint64_t));
+  for(; i + 8 <= count; i += 8) {
+    __m256i in = inside(_mm256_loadu_si256((const __m256i *)&filter[i]), l, h);
+    unsigned int bits = _mm256_movemask_ps(_mm256_castsi256_ps(in));
+    mask[i / 64] |= (uint64_t)bits << (i % 64);
+    n += __builtin_popcount(bits);
+  }
+  for(; i < count; i++) {
+    uint64_t bit = filter[i] >= low && filter[i] <= high;
+    mask[i / 64] |= bit << (i % 64);
+    n += bit;
+  }
+  return n;
+}
+
+bool QueryKernels::hasAVX2(void) { return __builtin_cpu_supports("avx2"); }
+
+#else
+
+#define aggregateAVX2 aggregateScalar
+#define aggregateFilteredAVX2 aggregateFilteredScalar
+#define matchAVX2 matchScalar
+
+bool QueryKernels::hasAVX2(void) { return false; }
+
+#endif
+
+static const QueryKernels scalarKernels = {aggregateScalar, aggregateFilteredScalar, matchScalar, "scalar"};
+static const QueryKernels avx2Kernels = {aggregateAVX2, aggregateFilteredAVX2, matchAVX2, "avx2"};
+
+const QueryKernels &QueryKernels::scalar(void) {
+
+  return scalarKernels;
+}
+
+const QueryKernels &QueryKernels::avx2(void) {
+
+  return hasAVX2() ? avx2Kernels : scalarKernels;
+}
+
+const QueryKernels &QueryKernels::best(void) {
+
+  return avx2();
+}
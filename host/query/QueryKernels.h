@@ -0,0 +1,47 @@
+/*
+ * QueryKernels.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Integer kernels of the query engine over decoded columns.
+ * All channels keep the firmware's 16-bit units (ppm, ppb,
+ * 1/100 degree, 1/100 percent), so the AVX2 backend adds 8
+ * values per step in 32-bit lanes and widens the sums to 64
+ * bits every QUERY_LANE_BLOCK steps.
+ *
+ * aggregate()          count, sum, min and max of a range
+ * aggregateFiltered()  the same for values whose filter column
+ *                      is within [low, high]
+ * match()              bit mask of the samples within [low, high]
+ *
+ * All backends give identical results, best() selects AVX2 if
+ * the CPU has it.
+ */
+
+#ifndef QUERYKERNELS_H_
+#define QUERYKERNELS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "TimeSeriesFile.h"
+
+// Steps until a 32-bit lane could overflow with 16-bit values
+#define QUERY_LANE_BLOCK      4096
+
+struct QueryKernels {
+  void (*aggregate)(const int32_t *values, size_t count, ChannelStats *stats);
+  void (*aggregateFiltered)(const int32_t *values, const int32_t *filter, size_t count,
+                            int32_t low, int32_t high, ChannelStats *stats);
+  // mask needs (count + 63) / 64 words, return: count of set bits
+  size_t (*match)(const int32_t *filter, size_t count, int32_t low, int32_t high, uint64_t *mask);
+  const char *name;
+
+  static const QueryKernels &scalar(void);
+  static const QueryKernels &avx2(void);    // scalar without AVX2
+  static const QueryKernels &best(void);
+  static bool hasAVX2(void);
+};
+
+#endif /* QUERYKERNELS_H_ */
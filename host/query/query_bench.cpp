@@ -0,0 +1,318 @@
+/*
+ * query_bench.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Writes a synthetic year of readings for many devices and
+ * runs typical queries with a naive reference (every sample
+ * decoded, one thread) and with the query engine on one and
+ * all threads, scalar and vectorized. Fails if any result
+ * differs from the reference.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -pthread -Ihost/tsdb -Ihost/query -o lp_query_bench \
+ *       host/query/query_bench.cpp host/query/QueryEngine.cpp host/query/QueryKernels.cpp \
+ *       host/tsdb/TimeSeriesFile.cpp
+ *
+ * Usage:
+ *   lp_query_bench [-d devices] [-i interval] [-j threads] [-o file.lpts]
+ *
+ *   interval  s between two readings of a device (default 60)
+ *   file      kept and reused if it exists
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "QueryEngine.h"
+
+#define BENCH_START         1735689600000LL   // 2025-01-01 00:00 UTC
+#define BENCH_DAYS          365
+#define DAY                 86400000LL
+
+static double now(void) {
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int clamp(int value, int low, int high) {
+
+  return value < low ? low : (value > high ? high : value);
+}
+
+//*********************************************************
+// A room per device: CO2 and TVOC rise while it's used on
+// working days, temperature and humidity follow the day and
+// the season. The devices are offline now and then, every
+// second one also on the Thursday of week 20 from 10:00 to
+// 11:30, in the middle of a run above 1000 ppm.
+//*********************************************************
+static bool generate(const std::string &path, unsigned long devices, unsigned long interval) {
+
+  TimeSeriesWriter writer;
+  if(!writer.open(path))
+    return false;
+
+  std::mt19937 random(1);
+  std::normal_distribution<double> noise(0, 1);
+  unsigned long perDevice = BENCH_DAYS * (DAY / 1000) / interval;
+
+  for(unsigned long d = 0; d < devices; d++) {
+    uint32_t id = 0x10000000 + d * 0x9E37;
+    double occupancy = 300 + random() % 900;      // ppm above outdoor air
+    double warmth = (random() % 300) - 150;       // 1/100 degree
+    double co2 = 420;
+    std::vector<std::pair<int64_t, int64_t> > outages;
+    for(int k = 0; k < 12; k++) {
+      int64_t begin = BENCH_START + (int64_t)(random() % (BENCH_DAYS * 24)) * 3600000;
+      outages.push_back(std::make_pair(begin, begin + (int64_t)(1 + random() % 48) * 3600000));
+    }
+    if(d % 2 == 0)
+      outages.push_back(std::make_pair(BENCH_START + (19 * 7 + 1) * DAY + 10 * 3600000LL,
+                                       BENCH_START + (19 * 7 + 1) * DAY + 11 * 3600000LL + 30 * 60000LL));
+    Sample s;
+    for(unsigned long n = 0; n < perDevice; n++) {
+      s.timestamp = BENCH_START + (int64_t)n * interval * 1000;
+      int64_t ms = s.timestamp % DAY;
+      int weekday = (s.timestamp / DAY + 3) % 7;    // 0 = Monday
+      double hour = ms / 3600000.0;
+      bool used = weekday < 5 && hour >= 8 && hour < 17 && !(hour >= 12 && hour < 13);
+      double season = cos(2 * M_PI * (s.timestamp - BENCH_START) / (365.0 * DAY));
+      double target = 420 + (used ? occupancy : 0);
+      co2 += (target - co2) * 0.05 * interval / 60 + 5 * noise(random);
+      s.sequence = (uint16_t)n;
+      s.co2 = clamp((int)co2, 400, 60000);
+      s.tvoc = clamp((int)((co2 - 400) / 4 + 3 * noise(random)), 0, 60000);
+      s.temperature = (int16_t)(2100 + warmth - 150 * season + 100 * sin(2 * M_PI * (hour - 9) / 24)
+                                + 10 * noise(random));
+      s.humidity = clamp((int)(4500 + 800 * season + 50 * noise(random)), 0, 10000);
+      bool offline = false;
+      for(size_t k = 0; k < outages.size(); k++) {
+        offline |= s.timestamp >= outages[k].first && s.timestamp < outages[k].second;
+      }
+      if(!offline)
+        writer.append(id, s);
+    }
+    writer.flush(id);
+  }
+  return writer.close();
+}
+
+//*********************************************************
+// Naive reference: decode everything, check every sample
+// The default gap of a run is taken from the smallest mean
+// interval of a device's chunks.
+//*********************************************************
+static QueryResult reference(const TimeSeriesReader &reader, const Query &query) {
+
+  QueryResult result;
+  std::map<std::pair<uint32_t, int64_t>, ChannelStats> groups;
+  std::map<uint32_t, std::vector<Sample> > devices;
+  std::map<uint32_t, int64_t> intervals;
+  std::vector<Sample> samples;
+
+  for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+    uint32_t device = reader.chunkRef(i).device;
+    if(!query.anyDevice && device != query.device)
+      continue;
+    samples.clear();
+    reader.decode(i, &samples);
+    if(samples.size() >= 2) {
+      int64_t mean = (samples.back().timestamp - samples.front().timestamp) / (int64_t)(samples.size() - 1);
+      if(!intervals.count(device) || mean < intervals[device])
+        intervals[device] = mean;
+    }
+    for(size_t n = 0; n < samples.size(); n++) {
+      const Sample &s = samples[n];
+      if(s.timestamp < query.from || s.timestamp > query.to)
+        continue;
+      if(query.minDuration > 0) {
+        devices[device].push_back(s);
+        continue;
+      }
+      if(query.filter >= 0 && (s.channel(query.filter) < query.filterMin || s.channel(query.filter) > query.filterMax))
+        continue;
+      int64_t window = 0;
+      if(query.window > 0)
+        window = (s.timestamp / query.window - (s.timestamp % query.window < 0)) * query.window;
+      groups[std::make_pair(query.byDevice ? device : 0, window)].add(s.channel(query.channel));
+    }
+  }
+
+  for(std::map<std::pair<uint32_t, int64_t>, ChannelStats>::const_iterator it = groups.begin(); it != groups.end(); ++it) {
+    QueryGroup group = {it->first.first, it->first.second, it->second};
+    result.groups.push_back(group);
+  }
+  for(std::map<uint32_t, std::vector<Sample> >::iterator it = devices.begin(); it != devices.end(); ++it) {
+    std::vector<Sample> &list = it->second;
+    std::stable_sort(list.begin(), list.end(), [](const Sample &a, const Sample &b) { return a.timestamp < b.timestamp; });
+    int64_t gap = query.maxGap > 0 ? query.maxGap : QUERY_GAP_INTERVALS * intervals[it->first];
+    QueryRun run;
+    bool open = false;
+    run.device = it->first;
+    for(size_t n = 0; n <= list.size(); n++) {
+      bool inside = n < list.size() && list[n].channel(query.filter) >= query.filterMin &&
+                    list[n].channel(query.filter) <= query.filterMax;
+      if(inside && open && gap > 0 && list[n].timestamp - run.end > gap) {
+        if(run.end - run.start >= query.minDuration)
+          result.runs.push_back(run);
+        open = false;
+      }
+      if(!inside) {
+        if(open && run.end - run.start >= query.minDuration)
+          result.runs.push_back(run);
+        open = false;
+        continue;
+      }
+      if(!open) {
+        run.start = list[n].timestamp;
+        run.stats = ChannelStats();
+        open = true;
+      }
+      run.end = list[n].timestamp;
+      run.stats.add(list[n].channel(query.channel));
+    }
+  }
+  return result;
+}
+
+static bool sameStats(const ChannelStats &a, const ChannelStats &b) {
+
+  return a.count == b.count && a.sum == b.sum && a.min == b.min && a.max == b.max;
+}
+
+static bool sameResult(const QueryResult &a, const QueryResult &b) {
+
+  if(a.groups.size() != b.groups.size() || a.runs.size() != b.runs.size())
+    return false;
+  for(size_t i = 0; i < a.groups.size(); i++) {
+    if(a.groups[i].device != b.groups[i].device || a.groups[i].window != b.groups[i].window ||
+       !sameStats(a.groups[i].stats, b.groups[i].stats))
+      return false;
+  }
+  for(size_t i = 0; i < a.runs.size(); i++) {
+    if(a.runs[i].device != b.runs[i].device || a.runs[i].start != b.runs[i].start ||
+       a.runs[i].end != b.runs[i].end || !sameStats(a.runs[i].stats, b.runs[i].stats))
+      return false;
+  }
+  return true;
+}
+
+static bool report(const char *name, double seconds, uint64_t samples, const QueryResult &result,
+                   const QueryResult &expected) {
+
+  bool same = sameResult(result, expected);
+  printf("  %-20s %8.1f ms %8.1f M samples/s  %6llu skipped %6llu index %6llu decoded  %s\n", name,
+         seconds * 1000, samples / seconds / 1e6, (unsigned long long)result.chunksSkipped,
+         (unsigned long long)result.chunksIndexed, (unsigned long long)result.chunksDecoded,
+         same ? "ok" : "MISMATCH");
+  return same;
+}
+
+int main(int argc, char **argv) {
+
+  unsigned long devices = 100;
+  unsigned long interval = 60;
+  unsigned int threads = std::thread::hardware_concurrency();
+  std::string path = "query_bench.lpts";
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "-d") && i + 1 < argc) devices = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-i") && i + 1 < argc) interval = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-j") && i + 1 < argc) threads = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-o") && i + 1 < argc) path = argv[++i];
+    else {
+      fprintf(stderr, "usage: %s [-d devices] [-i interval] [-j threads] [-o file.lpts]\n", argv[0]);
+      return 2;
+    }
+  }
+  if(devices == 0 || interval == 0) {
+    fprintf(stderr, "devices and interval must be positive\n");
+    return 2;
+  }
+  if(threads == 0)
+    threads = 1;
+
+  TimeSeriesReader reader;
+  if(!reader.open(path)) {
+    double start = now();
+    if(!generate(path, devices, interval) || !reader.open(path)) {
+      fprintf(stderr, "can't write %s\n", path.c_str());
+      return 1;
+    }
+    printf("generated %s in %.1f s\n", path.c_str(), now() - start);
+  }
+  uint64_t samples = 0;
+  for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+    samples += reader.chunkRef(i).count;
+  }
+  printf("%s: %u chunks, %llu samples (kernels %s, %u threads)\n", path.c_str(), reader.chunkCount(),
+         (unsigned long long)samples, QueryKernels::best().name, threads);
+
+  struct Benchmark {
+    const char *name;
+    Query query;
+  };
+  std::vector<Benchmark> benchmarks(5);
+  benchmarks[0].name = "co2 of the year";
+  benchmarks[1].name = "hourly temperature per device";
+  benchmarks[1].query.channel = TS_TEMPERATURE;
+  benchmarks[1].query.window = 3600000;
+  benchmarks[1].query.byDevice = true;
+  benchmarks[2].name = "humidity while co2 >= 1000, daily";
+  benchmarks[2].query.channel = TS_HUMIDITY;
+  benchmarks[2].query.filter = TS_CO2;
+  benchmarks[2].query.filterMin = 1000;
+  benchmarks[2].query.window = DAY;
+  benchmarks[3].name = "co2 >= 1000 for 30 min in week 20";
+  benchmarks[3].query.filter = TS_CO2;
+  benchmarks[3].query.filterMin = 1000;
+  benchmarks[3].query.minDuration = 30 * 60000;
+  benchmarks[3].query.from = BENCH_START + 19 * 7 * DAY;
+  benchmarks[3].query.to = BENCH_START + 20 * 7 * DAY - 1;
+  benchmarks[4].name = "co2 >= 1000 for 3 h, gaps up to 2 h";
+  benchmarks[4].query.filter = TS_CO2;
+  benchmarks[4].query.filterMin = 1000;
+  benchmarks[4].query.minDuration = 3 * 3600000;
+  benchmarks[4].query.maxGap = 2 * 3600000;
+
+  QueryEngine engine(reader);
+  bool ok = true;
+  for(size_t b = 0; b < benchmarks.size(); b++) {
+    const Query &query = benchmarks[b].query;
+    double start = now();
+    QueryResult expected = reference(reader, query);
+    double seconds = now() - start;
+    printf("%s: %u groups, %u runs\n", benchmarks[b].name, (unsigned int)expected.groups.size(),
+           (unsigned int)expected.runs.size());
+    printf("  %-20s %8.1f ms %8.1f M samples/s\n", "reference", seconds * 1000, samples / seconds / 1e6);
+
+    const struct {
+      const char *name;
+      const QueryKernels *kernels;
+      unsigned int threads;
+    } variants[] = {
+      {"scalar, 1 thread", &QueryKernels::scalar(), 1},
+      {"vector, 1 thread", &QueryKernels::best(), 1},
+      {"vector, all threads", &QueryKernels::best(), threads},
+    };
+    for(size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+      engine.setKernels(*variants[v].kernels);
+      engine.setThreads(variants[v].threads);
+      start = now();
+      QueryResult result = engine.run(query);
+      ok &= report(variants[v].name, now() - start, samples, result, expected);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*
+ * query_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Filter, group-by and window aggregates over .lpts files (see
+ * QueryEngine.h), written as CSV.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -pthread -Ihost/tsdb -Ihost/query -o lp_query \
+ *       host/query/query_main.cpp host/query/QueryEngine.cpp host/query/QueryKernels.cpp \
+ *       host/tsdb/TimeSeriesFile.cpp
+ *
+ * Usage:
+ *   lp_query file.lpts channel [-d device] [-f from] [-t to] [-w window] [-g]
+ *            [-F filter] [-r duration] [-G gap] [-j threads] [-s]
+ *
+ *   channel   aggregated channel: sequence, co2, tvoc, temperature or humidity
+ *   device    hexadecimal device ID
+ *   from, to  ms since 1970, inclusive
+ *   window    window length, e.g. 900000, 15m, 1h or 1d
+ *   -g        one group per device
+ *   filter    channel>=value, channel<=value or channel=min..max in the
+ *             stored units (ppm, ppb, 1/100 degree, 1/100 percent)
+ *   duration  list runs of filtered samples lasting at least this long
+ *   gap       a run ends where two samples are further apart (default
+ *             3 sample intervals of the device)
+ *   threads   0 = one per core (default)
+ *   -s        scalar kernels
+ *
+ * Examples:
+ *   hourly mean temperature per device
+ *     lp_query readings.lpts temperature -w 1h -g
+ *   devices above 1000 ppm CO2 for 30 minutes or longer
+ *     lp_query readings.lpts co2 -F 'co2>=1000' -r 30m -f 1760000000000 -t 1760604800000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <limits>
+
+#include "QueryEngine.h"
+
+static const char *channelNames[TS_CHANNELS] = {
+  "sequence", "co2", "tvoc", "temperature", "humidity"
+};
+
+static int usage(const char *name) {
+
+  fprintf(stderr, "usage: %s file.lpts channel [-d device] [-f from] [-t to] [-w window] [-g]\n"
+                  "       [-F filter] [-r duration] [-G gap] [-j threads] [-s]\n"
+                  "channel:  sequence, co2, tvoc, temperature, humidity\n"
+                  "window, duration, gap: ms or with unit s, m, h, d\n"
+                  "filter:   channel>=value, channel<=value, channel=min..max\n", name);
+  return 2;
+}
+
+static int channelOf(const char *name, size_t length) {
+
+  for(int c = 0; c < TS_CHANNELS; c++) {
+    if(strlen(channelNames[c]) == length && !strncmp(channelNames[c], name, length))
+      return c;
+  }
+  return -1;
+}
+
+// Duration in ms, e.g. 90000, 30m, 1h
+static bool parseDuration(const char *text, int64_t *duration) {
+
+  char *end;
+  long long value = strtoll(text, &end, 10);
+  if(end == text || value <= 0)
+    return false;
+  switch(*end) {
+    case 0: break;
+    case 's': value *= 1000; end++; break;
+    case 'm': value *= 60000; end++; break;
+    case 'h': value *= 3600000; end++; break;
+    case 'd': value *= 86400000; end++; break;
+    default: return false;
+  }
+  *duration = value;
+  return *end == 0;
+}
+
+static bool parseValue(const char *text, int32_t *value) {
+
+  char *end;
+  long number = strtol(text, &end, 10);
+  *value = (int32_t)number;
+  return end != text && *end == 0;
+}
+
+//*********************************************************
+// Parse a filter: co2>=1000, temperature<=1800 or
+// humidity=4000..6000
+//*********************************************************
+static bool parseFilter(const char *text, Query *query) {
+
+  const char *op = strpbrk(text, "<>=");
+  if(!op || (query->filter = channelOf(text, op - text)) < 0)
+    return false;
+  if(!strncmp(op, ">=", 2))
+    return parseValue(op + 2, &query->filterMin);
+  if(!strncmp(op, "<=", 2))
+    return parseValue(op + 2, &query->filterMax);
+  const char *range = strstr(op, "..");
+  if(*op != '=' || !range)
+    return false;
+  char low[16];
+  if(range - op - 1 >= (long)sizeof(low))
+    return false;
+  memcpy(low, op + 1, range - op - 1);
+  low[range - op - 1] = 0;
+  return parseValue(low, &query->filterMin) && parseValue(range + 2, &query->filterMax);
+}
+
+int main(int argc, char **argv) {
+
+  if(argc < 3)
+    return usage(argv[0]);
+
+  const char *path = argv[1];
+  Query query;
+  unsigned int threads = 0;
+  bool scalar = false;
+
+  query.channel = channelOf(argv[2], strlen(argv[2]));
+  if(query.channel < 0)
+    return usage(argv[0]);
+  for(int i = 3; i < argc; i++) {
+    if(!strcmp(argv[i], "-d") && i + 1 < argc) {
+      query.device = strtoul(argv[++i], 0, 16);
+      query.anyDevice = false;
+    }
+    else if(!strcmp(argv[i], "-f") && i + 1 < argc) query.from = strtoll(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc) query.to = strtoll(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-g")) query.byDevice = true;
+    else if(!strcmp(argv[i], "-j") && i + 1 < argc) threads = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-s")) scalar = true;
+    else if(!strcmp(argv[i], "-w") && i + 1 < argc) {
+      if(!parseDuration(argv[++i], &query.window))
+        return usage(argv[0]);
+    }
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc) {
+      if(!parseDuration(argv[++i], &query.minDuration))
+        return usage(argv[0]);
+    }
+    else if(!strcmp(argv[i], "-G") && i + 1 < argc) {
+      if(!parseDuration(argv[++i], &query.maxGap))
+        return usage(argv[0]);
+    }
+    else if(!strcmp(argv[i], "-F") && i + 1 < argc) {
+      if(!parseFilter(argv[++i], &query))
+        return usage(argv[0]);
+    }
+    else
+      return usage(argv[0]);
+  }
+  if(query.minDuration > 0 && query.filter < 0) {
+    fprintf(stderr, "-r needs a filter (-F)\n");
+    return 2;
+  }
+
+  TimeSeriesReader reader;
+  if(!reader.open(path)) {
+    fprintf(stderr, "%s is no valid .lpts file\n", path);
+    return 2;
+  }
+  QueryEngine engine(reader, threads);
+  if(scalar)
+    engine.setKernels(QueryKernels::scalar());
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  QueryResult result = engine.run(query);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if(query.minDuration > 0) {
+    printf("device,start,end,minutes,count,min,max,mean\n");
+    for(size_t i = 0; i < result.runs.size(); i++) {
+      const QueryRun &r = result.runs[i];
+      printf("%08x,%lld,%lld,%.1f,%llu,%d,%d,%.2f\n", (unsigned int)r.device, (long long)r.start, (long long)r.end,
+             (r.end - r.start) / 60000.0, (unsigned long long)r.stats.count, r.stats.min, r.stats.max,
+             (double)r.stats.sum / r.stats.count);
+    }
+  }
+  else {
+    printf("device,window,count,min,max,mean\n");
+    for(size_t i = 0; i < result.groups.size(); i++) {
+      const QueryGroup &g = result.groups[i];
+      printf("%08x,%lld,%llu,%d,%d,%.2f\n", (unsigned int)g.device, (long long)g.window,
+             (unsigned long long)g.stats.count, g.stats.min, g.stats.max, (double)g.stats.sum / g.stats.count);
+    }
+  }
+
+  fprintf(stderr, "%s: %llu chunks skipped, %llu from the index, %llu decoded (%llu samples), "
+                  "%u threads, %s kernels, %.3f s\n", channelNames[query.channel],
+          (unsigned long long)result.chunksSkipped, (unsigned long long)result.chunksIndexed,
+          (unsigned long long)result.chunksDecoded, (unsigned long long)result.samplesScanned,
+          engine.getThreads(), engine.getKernels().name, seconds);
+  return 0;
+}
@@ -0,0 +1,600 @@
+/*
+ * replay.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Replays a captured I2C trace (see I2CTrace.h) through the
+ * unmodified SGP30, SHT21 and GUI code. The replay follows the
+ * recorded command bytes instead of a fixed measurement cycle:
+ * every write starts the driver call that sends it (SGP30
+ * command, SHT21 measurement, user register, resets), every
+ * response is fetched by the driver again. So it works for
+ * whatever sequence the firmware ran, boot, recovery and
+ * bursts included. The transactions the drivers issue are
+ * matched against the recording, the decoded responses and
+ * the display content are written as CSV and can be compared
+ * with a previous run. Time is virtual, a day of traffic
+ * replays in seconds.
+ *
+ * --energy adds the energy accounting of main.ino (see
+ * Energy.h). Every transferred byte takes the given time
+ * (9 clocks at 100 kHz by default), the CPU is counted as
+ * active only during transactions, as the scheduler sleeps
+ * through the conversion times. --current overrides the
+ * current model, e.g. --current sgp30=48000/2.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/shim -Ihost/common -Ihost/crc -I. -o lp_replay \
+ *       host/replay/replay.cpp host/common/FrameScanner.cpp host/crc/SlicedCRC.cpp host/shim/Shim.cpp \
+ *       SGP30.cpp SHT21.cpp GUI.cpp crc.cpp Telemetry.cpp I2CTrace.cpp I2CBus.cpp Energy.cpp
+ *
+ * Usage:
+ *   lp_replay trace.bin [--csv out.csv] [--expect golden.csv] [--strict]
+ *             [--energy] [--byte-time us] [--current name=active[/idle] ...]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Energia.h"
+#include "LCD_Launchpad.h"
+#include "I2CBus.h"
+#include "FrameScanner.h"
+#include "Telemetry.h"
+#include "SGP30.h"
+#include "SHT21.h"
+#include "GUI.h"
+#include "Energy.h"
+
+// Objects the drivers expect (see main.ino)
+I2CBus Wire(0, 0);
+CRC crc;
+Telemetry telemetry;
+LCD_LAUNCHPAD lcd;
+SGP30 sgp30;
+SHT21 sht21;
+GUI gui;
+Energy energy;
+
+#define DEFAULT_BYTE_TIME   90      // us, 8 data bits and ACK at 100 kHz
+
+static const char *componentNames[ENERGY_COMPONENTS] = {"cpu", "i2c", "sht21", "sgp30", "lcd"};
+
+// Indexed by SGP30_CMD_xxx
+static const char *sgp30Names[SGP30_CMD_COUNT] = {
+  "init_air_quality", "measure_air_quality", "get_baseline", "set_baseline",
+  "measure_test", "get_feature_set_version", "measure_signals", "get_serial_id"
+};
+
+struct TraceRecord {
+  uint32_t time;
+  uint8_t key;          // address << 1 | direction
+  uint8_t status;
+  bool used;
+  std::vector<uint8_t> data;
+};
+
+//***************************
+// Serves the drivers' transactions from the recording.
+// The records stay in trace order for the dispatcher and
+// are queued per slave address and direction for the
+// drivers, so a driver that reorders its write and read
+// phases still replays against an older trace.
+//***************************
+class ReplayBackend : public I2CBackend {
+  private:
+    std::vector<TraceRecord> records;
+    std::map<uint8_t, std::deque<size_t> > queues;
+    size_t position;      // first unused record
+
+    TraceRecord *peek(uint8_t key, size_t n) {
+      std::deque<size_t> &queue = queues[key];
+      while(!queue.empty() && records[queue.front()].used) {
+        queue.pop_front();
+      }
+      for(size_t i = 0; i < queue.size(); i++) {
+        if(!records[queue[i]].used && n-- == 0)
+          return &records[queue[i]];
+      }
+      return 0;
+    }
+
+    void consume(TraceRecord *record) {
+      advance(record);
+      record->used = true;
+      consumed++;
+    }
+
+  public:
+    unsigned long loaded;
+    unsigned long consumed;
+    unsigned long skipped;
+    unsigned long mismatches;
+
+    ReplayBackend() : position(0), loaded(0), consumed(0), skipped(0), mismatches(0) {}
+
+    void add(const Frame &frame) {
+      TraceRecord record;
+      record.time = getUInt32(frame.payload);
+      record.key = frame.payload[4];
+      record.status = frame.payload[5];
+      record.used = false;
+      record.data.assign(frame.payload + I2C_TRACE_RECORD_HEADER, frame.payload + frame.length);
+      queues[record.key].push_back(records.size());
+      records.push_back(record);
+      loaded++;
+    }
+
+    // Virtual time to the start of a recorded transaction
+    void advance(const TraceRecord *record) {
+      uint64_t recorded = (uint64_t)record->time * 1000;
+      if(recorded > shim::nowMicros())
+        shim::setMicros(recorded);
+    }
+
+    // First record no driver has taken yet, 0 at the end
+    TraceRecord *next(void) {
+      while(position < records.size() && records[position].used) {
+        position++;
+      }
+      return position < records.size() ? &records[position] : 0;
+    }
+
+    // n-th record still queued for a slave address and direction
+    TraceRecord *queued(uint8_t address, uint8_t direction, size_t n) {
+      return peek((address << 1) | direction, n);
+    }
+
+    // A record the replay can't map to a driver call
+    void skip(TraceRecord *record, const char *reason) {
+      fprintf(stderr, "skipped: %s of %u bytes %s 0x%02X at %lu ms, %s\n",
+              (record->key & 1) == I2C_TRACE_READ ? "read" : "write", (unsigned int)record->data.size(),
+              (record->key & 1) == I2C_TRACE_READ ? "from" : "to", record->key >> 1,
+              (unsigned long)record->time, reason);
+      record->used = true;
+      skipped++;
+    }
+
+    uint8_t write(uint8_t address, const uint8_t *data, uint8_t length) {
+      TraceRecord *record = peek((address << 1) | I2C_TRACE_WRITE, 0);
+      if(!record) {
+        fprintf(stderr, "mismatch: write to 0x%02X after the end of the trace\n", address);
+        mismatches++;
+        return 2;   // address NACK
+      }
+      if(record->data.size() != length || (length && memcmp(&record->data[0], data, length) != 0)) {
+        fprintf(stderr, "mismatch: write to 0x%02X at %lu ms differs from trace\n", address, (unsigned long)record->time);
+        mismatches++;
+      }
+      uint8_t status = record->status;
+      consume(record);
+      return status;
+    }
+
+    uint8_t read(uint8_t address, uint8_t *data, uint8_t length) {
+      TraceRecord *record = peek((address << 1) | I2C_TRACE_READ, 0);
+      if(!record) {
+        fprintf(stderr, "mismatch: read from 0x%02X after the end of the trace\n", address);
+        mismatches++;
+        return 0;
+      }
+      if(record->data.size() != length) {
+        fprintf(stderr, "mismatch: read of %u bytes from 0x%02X at %lu ms, trace has %u\n",
+                length, address, (unsigned long)record->time, (unsigned int)record->data.size());
+        mismatches++;
+      }
+      uint8_t count = record->data.size() < length ? record->data.size() : length;
+      if(count)
+        memcpy(data, &record->data[0], count);
+      consume(record);
+      return count;
+    }
+};
+
+//***************************
+// Starts the driver call behind the next recorded
+// transaction and writes a CSV line for every response
+// and every command without one
+//***************************
+class Dispatcher {
+  private:
+    ReplayBackend &backend;
+    uint8_t sht21Pending;     // HUMIDITY, TEMP or 0
+
+    void line(const char *command, const char *result, const std::string &display) {
+      char text[160];
+      snprintf(text, sizeof(text), "%lu,%s,%s,%s\n", millis(), command, result, display.c_str());
+      csv += text;
+      lines++;
+    }
+
+    void sgp30Command(TraceRecord *record);
+    void sgp30Response(TraceRecord *record);
+    void sht21Command(TraceRecord *record);
+    void sht21Response(TraceRecord *record);
+
+  public:
+    std::string csv;
+    unsigned long lines;
+
+    Dispatcher(ReplayBackend &trace)
+      : backend(trace), sht21Pending(0), csv("t_ms,command,result,lcd\n"), lines(0) {}
+
+    bool step(void);
+};
+
+void Dispatcher::sgp30Command(TraceRecord *record) {
+
+  if(record->data.size() < 2) {
+    backend.skip(record, "no command");
+    return;
+  }
+  uint16_t code = (uint16_t)record->data[0] << 8 | record->data[1];
+  uint8_t command = 0;
+  while(command < SGP30_CMD_COUNT && SGP30::command(command)->code != code) {
+    command++;
+  }
+  if(command == SGP30_CMD_COUNT) {
+    backend.skip(record, "unknown SGP30 command");
+    return;
+  }
+  const SGP30Command *c = SGP30::command(command);
+  if(record->data.size() != 2 + 3 * (size_t)c->txWords) {
+    backend.skip(record, "wrong parameter length");
+    return;
+  }
+  uint16_t parameters[SGP30_MAX_WORDS];
+  for(uint8_t k = 0; k < c->txWords; k++) {
+    parameters[k] = (uint16_t)record->data[2 + 3 * k] << 8 | record->data[3 + 3 * k];
+  }
+  sgp30.start(command, parameters);
+  if(c->rxWords == 0)
+    line(sgp30Names[command], "", "");
+}
+
+void Dispatcher::sgp30Response(TraceRecord *record) {
+
+  uint8_t command = sgp30.pendingCommand();
+  if(command == SGP30_CMD_NONE || SGP30::command(command)->rxWords == 0) {
+    backend.skip(record, "no SGP30 command waiting for it");
+    return;
+  }
+  uint16_t words[SGP30_MAX_WORDS] = {0};
+  char result[64];
+  std::string display;
+  if(!sgp30.finish(words))
+    snprintf(result, sizeof(result), "crc error");
+  else if(command == SGP30_CMD_MEASURE_AIR_QUALITY) {
+    snprintf(result, sizeof(result), "co2=%u tvoc=%u", words[0], words[1]);
+    gui.showCO2(words[0]);
+    display = lcd.snapshot();
+  }
+  else if(command == SGP30_CMD_MEASURE_SIGNALS)
+    snprintf(result, sizeof(result), "h2=%u ethanol=%u", words[0], words[1]);
+  else if(command == SGP30_CMD_GET_SERIAL_ID)
+    snprintf(result, sizeof(result), "%04X%04X%04X", words[0], words[1], words[2]);
+  else if(command == SGP30_CMD_GET_BASELINE)
+    snprintf(result, sizeof(result), "co2=0x%04X tvoc=0x%04X", words[0], words[1]);
+  else
+    snprintf(result, sizeof(result), "0x%04X", words[0]);
+  line(sgp30Names[command], result, display);
+}
+
+void Dispatcher::sht21Command(TraceRecord *record) {
+
+  if(record->data.empty()) {
+    backend.skip(record, "no command");
+    return;
+  }
+  char result[16];
+  switch(record->data[0]) {
+    case SHT21_TRIGGER_RH_MEAS:
+      sht21.startMeasurement(HUMIDITY);
+      sht21Pending = HUMIDITY;
+      break;
+    case SHT21_TRIGGER_T_MEAS:
+      sht21.startMeasurement(TEMP);
+      sht21Pending = TEMP;
+      break;
+    case SHT21_READ_USER_REG: {
+      // setResolution() reads the register and writes it back
+      TraceRecord *update = backend.queued(SHT21_ADDRESS, I2C_TRACE_WRITE, 1);
+      if(!update || update->data.size() != 2 || update->data[0] != SHT21_WRITE_USER_REG) {
+        backend.skip(record, "user register read without write");
+        return;
+      }
+      sht21.setResolution(update->data[1]);
+      snprintf(result, sizeof(result), "0x%02X", sht21.getResolution());
+      line("sht21_resolution", result, "");
+      break;
+    }
+    case SHT21_RESET:
+      sht21.startReset();
+      sht21Pending = 0;
+      line("sht21_reset", "", "");
+      break;
+    default:
+      backend.skip(record, "unknown SHT21 command");
+      break;
+  }
+}
+
+void Dispatcher::sht21Response(TraceRecord *record) {
+
+  if(!sht21Pending) {
+    backend.skip(record, "no SHT21 measurement started");
+    return;
+  }
+  char result[32];
+  float value;
+  if(!sht21.readMeasurement(sht21Pending, &value)) {
+    line(sht21Pending == HUMIDITY ? "sht21_humidity" : "sht21_temperature", "crc error", "");
+    sht21Pending = 0;
+    return;
+  }
+  if(sht21Pending == HUMIDITY) {
+    snprintf(result, sizeof(result), "humidity=%.2f", value);
+    gui.showHumidity(value);
+  }
+  else {
+    snprintf(result, sizeof(result), "temperature=%.2f", value);
+    gui.showTemperature(value);
+  }
+  line(sht21Pending == HUMIDITY ? "sht21_humidity" : "sht21_temperature", result, lcd.snapshot());
+  sht21Pending = 0;
+}
+
+//*********************************************************
+// Replay the next recorded transaction
+//
+// input:   none
+//
+// output:  none
+//
+// return:  false at the end of the trace
+//*********************************************************
+bool Dispatcher::step(void) {
+
+  TraceRecord *record = backend.next();
+  if(!record)
+    return false;
+
+  // Before the driver call, I2CBus would count the jump as busy time
+  backend.advance(record);
+  uint8_t address = record->key >> 1;
+  bool read = (record->key & 1) == I2C_TRACE_READ;
+  if(address == I2C_GENERAL_CALL_ADDRESS && !read) {
+    sgp30.softReset();
+    line("general_call_reset", "", "");
+  }
+  else if(address == SGP30_ADDRESS)
+    read ? sgp30Response(record) : sgp30Command(record);
+  else if(address == SHT21_ADDRESS)
+    read ? sht21Response(record) : sht21Command(record);
+  else
+    backend.skip(record, "unknown address");
+
+  // A driver that doesn't send what the trace has
+  if(!record->used)
+    backend.skip(record, "not sent by the driver");
+  return true;
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> *content) {
+
+  FILE *file = fopen(path, "rb");
+  if(!file)
+    return false;
+  uint8_t buffer[65536];
+  size_t n;
+  while((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content->insert(content->end(), buffer, buffer + n);
+  }
+  fclose(file);
+  return true;
+}
+
+static std::vector<std::string> splitLines(const std::string &text) {
+
+  std::vector<std::string> lines;
+  size_t start = 0;
+  while(start < text.size()) {
+    size_t end = text.find('\n', start);
+    if(end == std::string::npos)
+      end = text.size();
+    lines.push_back(text.substr(start, end - start));
+    start = end + 1;
+  }
+  return lines;
+}
+
+//*********************************************************
+// Apply one --current name=active[/idle] argument (uA)
+//*********************************************************
+static bool setCurrent(EnergyModel *model, const char *argument) {
+
+  const char *value = strchr(argument, '=');
+  if(!value)
+    return false;
+  for(int i = 0; i < ENERGY_COMPONENTS; i++) {
+    if(strlen(componentNames[i]) != (size_t)(value - argument) ||
+       strncmp(componentNames[i], argument, value - argument))
+      continue;
+    char *end;
+    unsigned long active = strtoul(value + 1, &end, 10);
+    unsigned long idle = model->idle[i];
+    if(end == value + 1 || active > 0xFFFF)
+      return false;
+    if(*end == '/') {
+      const char *start = end + 1;
+      idle = strtoul(start, &end, 10);
+      if(end == start || idle > 0xFFFF)
+        return false;
+    }
+    if(*end)
+      return false;
+    model->active[i] = active;
+    model->idle[i] = idle;
+    return true;
+  }
+  return false;
+}
+
+static size_t countErrors(const std::string &output) {
+
+  size_t count = 0;
+  for(size_t at = output.find("ERROR"); at != std::string::npos; at = output.find("ERROR", at + 1)) {
+    count++;
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+
+  const char *tracePath = 0;
+  const char *csvPath = 0;
+  const char *expectPath = 0;
+  bool strict = false;
+  bool accounting = false;
+  unsigned int byteTime = DEFAULT_BYTE_TIME;
+  EnergyModel model = *energy.getModel();
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--csv") && i + 1 < argc) csvPath = argv[++i];
+    else if(!strcmp(argv[i], "--expect") && i + 1 < argc) expectPath = argv[++i];
+    else if(!strcmp(argv[i], "--strict")) strict = true;
+    else if(!strcmp(argv[i], "--energy")) accounting = true;
+    else if(!strcmp(argv[i], "--byte-time") && i + 1 < argc) byteTime = strtoul(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "--current") && i + 1 < argc) {
+      if(!setCurrent(&model, argv[++i])) {
+        fprintf(stderr, "invalid current: %s (cpu|i2c|sht21|sgp30|lcd=uA[/uA])\n", argv[i]);
+        return 2;
+      }
+      accounting = true;
+    }
+    else if(!tracePath) tracePath = argv[i];
+    else {
+      fprintf(stderr, "unexpected argument: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if(!tracePath) {
+    fprintf(stderr, "usage: %s trace.bin [--csv out.csv] [--expect golden.csv] [--strict]\n"
+                    "       [--energy] [--byte-time us] [--current name=active[/idle] ...]\n", argv[0]);
+    return 2;
+  }
+
+  crc.Init();
+
+  std::vector<uint8_t> raw;
+  if(!readFile(tracePath, &raw)) {
+    fprintf(stderr, "can't read %s\n", tracePath);
+    return 2;
+  }
+
+  ReplayBackend backend;
+  FrameScanner scanner;
+  Frame frame;
+  uint32_t firstTime = 0, lastTime = 0;
+  scanner.feed(raw.empty() ? 0 : &raw[0], raw.size());
+  while(scanner.next(&frame)) {
+    if(frame.type != TELEMETRY_FRAME_TRACE || frame.length < I2C_TRACE_RECORD_HEADER)
+      continue;
+    uint32_t time = getUInt32(frame.payload);
+    if(backend.loaded == 0)
+      firstTime = time;
+    lastTime = time;
+    backend.add(frame);
+  }
+  shim::setI2CBackend(&backend);
+  shim::setMicros((uint64_t)firstTime * 1000);
+  // Transfer times shift the replay, only with --energy
+  if(accounting) {
+    shim::setI2CByteTime(byteTime);
+    energy.setModel(&model);
+    energy.begin();
+  }
+  unsigned long replayStart = millis();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  Dispatcher dispatcher(backend);
+  while(dispatcher.step()) {
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double simulated = (lastTime - firstTime) / 1000.0;
+  size_t errors = countErrors(Serial.output);
+
+  printf("frames: %lu valid, %lu bad crc, %lu bytes skipped\n",
+         scanner.framesValid, scanner.framesBadCRC, scanner.bytesSkipped);
+  printf("transactions: %lu replayed, %lu skipped, %lu mismatches\n",
+         backend.consumed, backend.skipped, backend.mismatches);
+  printf("results: %lu, driver errors: %u\n", dispatcher.lines, (unsigned int)errors);
+  printf("time: %.1f s recorded in %.3f s (%.0fx real time)\n",
+         simulated, wall, wall > 0 ? simulated / wall : 0.0);
+
+  if(accounting) {
+    // The CPU sleeps whenever it doesn't drive the bus
+    unsigned long busy = Wire.getBusyTime();
+    energy.addSleep(millis() - replayStart - busy / 1000);
+    energy.update(busy, sht21.getConversionTime(), sgp30.getHeaterTime());
+    printf("energy: %.1f s, %u us per byte\n", energy.getElapsed() / 1000.0, byteTime);
+    for(uint8_t i = 0; i < ENERGY_COMPONENTS; i++) {
+      uint32_t active = energy.getActive(i);
+      printf("  %-6s active %10.3f s (%5.1f%%), low power %10.3f s, %10.3f uAh/h\n", componentNames[i],
+             active / 1000.0, energy.getElapsed() ? 100.0 * active / energy.getElapsed() : 0.0,
+             (energy.getElapsed() - (active < energy.getElapsed() ? active : energy.getElapsed())) / 1000.0,
+             energy.averageCurrent(i) / 1000.0);
+    }
+    printf("  total %.3f uAh/h\n", energy.averageCurrent() / 1000.0);
+  }
+
+  if(csvPath) {
+    FILE *file = fopen(csvPath, "w");
+    if(!file) {
+      fprintf(stderr, "can't write %s\n", csvPath);
+      return 2;
+    }
+    fwrite(dispatcher.csv.data(), 1, dispatcher.csv.size(), file);
+    fclose(file);
+  }
+
+  int result = 0;
+  if(backend.mismatches > 0)
+    result = 1;
+  if(strict && backend.skipped > 0)
+    result = 1;
+
+  if(expectPath) {
+    std::vector<uint8_t> expected;
+    if(!readFile(expectPath, &expected)) {
+      fprintf(stderr, "can't read %s\n", expectPath);
+      return 2;
+    }
+    std::vector<std::string> want = splitLines(std::string(expected.begin(), expected.end()));
+    std::vector<std::string> got = splitLines(dispatcher.csv);
+    size_t n = want.size() > got.size() ? want.size() : got.size();
+    for(size_t i = 0; i < n; i++) {
+      std::string a = i < want.size() ? want[i] : "<missing>";
+      std::string b = i < got.size() ? got[i] : "<missing>";
+      if(a != b) {
+        printf("output differs at line %u:\n  expected: %s\n  got:      %s\n",
+               (unsigned int)(i + 1), a.c_str(), b.c_str());
+        result = 1;
+        break;
+      }
+    }
+    if(result == 0)
+      printf("output matches %s\n", expectPath);
+  }
+
+  return result;
+}
@@ -0,0 +1,99 @@
+/*
+ * Energia.h (host shim)
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Minimal replacement of the Energia core, so the sensor
+ * drivers can be compiled and run on a PC. Time is virtual:
+ * delay() and sleep() only advance the clock, which lets
+ * host tools run much faster than real time.
+ */
+
+#ifndef SHIM_ENERGIA_H_
+#define SHIM_ENERGIA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <deque>
+
+typedef uint8_t boolean;
+
+#define HIGH        1
+#define LOW         0
+#define INPUT       0
+#define OUTPUT      1
+#define INPUT_PULLUP 2
+#define FALLING     2
+#define RISING      3
+
+//***************************
+// Virtual clock
+//***************************
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void sleep(unsigned long ms);
+
+namespace shim {
+  void setMicros(uint64_t us);
+  void advanceMicros(uint64_t us);
+  uint64_t nowMicros(void);
+}
+
+//***************************
+// Digital pins
+// Without a model, inputs read HIGH (pull-ups) and
+// outputs read back their level.
+//***************************
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+class PinModel {
+  public:
+    virtual ~PinModel() {}
+    // return: level seen on the pin
+    virtual int read(uint8_t pin, uint8_t mode, uint8_t level) = 0;
+    // called on every change of mode or output level
+    virtual void update(uint8_t pin, uint8_t mode, uint8_t level) { (void)pin; (void)mode; (void)level; }
+};
+
+namespace shim {
+  void setPinModel(PinModel *model);
+}
+
+//***************************
+// Serial interface
+// Output is collected in memory, input is fed by the host tool.
+//***************************
+class HardwareSerial {
+  public:
+    std::string output;
+    std::deque<uint8_t> input;
+    unsigned long baud;
+
+    HardwareSerial() : baud(0) {}
+    void begin(unsigned long baudRate) { baud = baudRate; }
+    void end(void) {}
+    int available(void) { return (int)input.size(); }
+    int read(void);
+    void flush(void) {}
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    size_t print(const char *text);
+    size_t print(char c);
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(double value, int digits = 2);
+    size_t println(void);
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+};
+
+extern HardwareSerial Serial;
+
+#endif /* SHIM_ENERGIA_H_ */
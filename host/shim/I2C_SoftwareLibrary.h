@@ -0,0 +1,55 @@
+/*
+ * I2C_SoftwareLibrary.h (host shim)
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * SoftwareWire with the API used by the drivers. Every
+ * transaction is forwarded to an I2CBackend installed by
+ * the host tool (trace replay, sensor model, ...).
+ */
+
+#ifndef SHIM_I2C_SOFTWARELIBRARY_H_
+#define SHIM_I2C_SOFTWARELIBRARY_H_
+
+#include "Energia.h"
+
+#define SHIM_I2C_BUFFER   32
+
+class I2CBackend {
+  public:
+    virtual ~I2CBackend() {}
+    // return: 0 on success, like endTransmission()
+    virtual uint8_t write(uint8_t address, const uint8_t *data, uint8_t length) = 0;
+    // return: count of bytes stored in *data
+    virtual uint8_t read(uint8_t address, uint8_t *data, uint8_t length) = 0;
+};
+
+namespace shim {
+  void setI2CBackend(I2CBackend *backend);
+  // Virtual time per byte incl. acknowledge, 0 = transactions take no time
+  void setI2CByteTime(unsigned int us);
+}
+
+class SoftwareWire {
+  private:
+    uint8_t address;
+    uint8_t txLength;
+    uint8_t rxLength;
+    uint8_t rxIndex;
+    uint8_t txBuffer[SHIM_I2C_BUFFER];
+    uint8_t rxBuffer[SHIM_I2C_BUFFER];
+
+  public:
+    SoftwareWire(uint8_t pinSDA, uint8_t pinSCL);
+    void begin(void);
+    void beginTransmission(uint8_t slaveAddress);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    uint8_t endTransmission(void);
+    uint8_t requestFrom(uint8_t slaveAddress, uint8_t quantity);
+    int available(void);
+    int read(void);
+};
+
+#endif /* SHIM_I2C_SOFTWARELIBRARY_H_ */
@@ -0,0 +1,43 @@
+/*
+ * LCD_Launchpad.h (host shim)
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Keeps the displayed characters and symbols in memory,
+ * so host tools can check what the GUI would show.
+ */
+
+#ifndef SHIM_LCD_LAUNCHPAD_H_
+#define SHIM_LCD_LAUNCHPAD_H_
+
+#include "Energia.h"
+
+#define LCD_DIGITS  6
+
+enum {
+  LCD_SEG_DOT1, LCD_SEG_DOT2, LCD_SEG_DOT3, LCD_SEG_DOT4, LCD_SEG_DOT5,
+  LCD_SEG_COLON2, LCD_SEG_COLON4, LCD_SEG_RADIO, LCD_SEG_CLOCK, LCD_SEG_HEART,
+  LCD_SEG_MARK, LCD_SEG_R, LCD_SEG_MINUS1, LCD_SEG_MINUS2, LCD_SEG_MINUS3,
+  LCD_SEG_MINUS4, LCD_SEG_MINUS5, LCD_SEG_DEG2, LCD_SEG_DEG4,
+  LCD_SEG_BAT_ENDS, LCD_SEG_BAT_POL, LCD_SEG_BAT0, LCD_SEG_BAT1, LCD_SEG_BAT2,
+  LCD_SEG_BAT3, LCD_SEG_BAT4, LCD_SEG_BAT5, LCD_SEG_COUNT
+};
+
+class LCD_LAUNCHPAD {
+  public:
+    char text[LCD_DIGITS + 1];
+    uint32_t symbols;
+    unsigned long updates;
+
+    LCD_LAUNCHPAD();
+    void init(void);
+    void clear(void);
+    void showChar(char c, int position);
+    void showSymbol(int symbol, int on);
+    void displayText(const char *s, int position = 0);
+    void displayScrollText(const char *s, int wait);
+    std::string snapshot(void) const;
+};
+
+#endif /* SHIM_LCD_LAUNCHPAD_H_ */
@@ -0,0 +1,279 @@
+/*
+ * Shim.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Host implementation of the Energia shim (clock, pins, Serial,
+ * SoftwareWire, LCD and itoa).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Energia.h"
+#include "I2C_SoftwareLibrary.h"
+#include "LCD_Launchpad.h"
+#include "itoa.h"
+
+HardwareSerial Serial;
+
+static uint64_t clockMicros = 0;
+static I2CBackend *i2cBackend = 0;
+
+//***************************
+// Virtual clock
+//***************************
+void shim::setMicros(uint64_t us) { clockMicros = us; }
+void shim::advanceMicros(uint64_t us) { clockMicros += us; }
+uint64_t shim::nowMicros(void) { return clockMicros; }
+
+unsigned long millis(void) { return (unsigned long)(uint32_t)(clockMicros / 1000); }
+unsigned long micros(void) { return (unsigned long)(uint32_t)clockMicros; }
+void delay(unsigned long ms) { clockMicros += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { clockMicros += us; }
+void sleep(unsigned long ms) { clockMicros += (uint64_t)ms * 1000; }
+
+//***************************
+// Digital pins
+//***************************
+#define SHIM_PINS   256
+
+static uint8_t pinModes[SHIM_PINS];
+static uint8_t pinLevels[SHIM_PINS];
+static PinModel *pinModel = 0;
+
+void shim::setPinModel(PinModel *model) { pinModel = model; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+
+  pinModes[pin] = mode;
+  if(pinModel)
+    pinModel->update(pin, mode, pinLevels[pin]);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+
+  pinLevels[pin] = level;
+  if(pinModel)
+    pinModel->update(pin, pinModes[pin], level);
+}
+
+int digitalRead(uint8_t pin) {
+
+  if(pinModel)
+    return pinModel->read(pin, pinModes[pin], pinLevels[pin]);
+  return pinModes[pin] == OUTPUT ? pinLevels[pin] : HIGH;
+}
+
+//***************************
+// Serial interface
+//***************************
+int HardwareSerial::read(void) {
+
+  if(input.empty())
+    return -1;
+  uint8_t data = input.front();
+  input.pop_front();
+  return data;
+}
+
+size_t HardwareSerial::write(uint8_t data) {
+
+  output.push_back((char)data);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t quantity) {
+
+  output.append((const char *)data, quantity);
+  return quantity;
+}
+
+size_t HardwareSerial::print(const char *text) {
+
+  size_t length = strlen(text);
+  output.append(text, length);
+  return length;
+}
+
+size_t HardwareSerial::print(char c) { return write((uint8_t)c); }
+
+size_t HardwareSerial::print(int value) { return print((long)value); }
+
+size_t HardwareSerial::print(unsigned int value) { return print((unsigned long)value); }
+
+size_t HardwareSerial::print(long value) {
+
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", value);
+  return print(text);
+}
+
+size_t HardwareSerial::print(unsigned long value) {
+
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", value);
+  return print(text);
+}
+
+size_t HardwareSerial::print(double value, int digits) {
+
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return print(text);
+}
+
+size_t HardwareSerial::println(void) { return print("\r\n"); }
+
+//***************************
+// SoftwareWire
+//***************************
+void shim::setI2CBackend(I2CBackend *backend) { i2cBackend = backend; }
+
+static unsigned int i2cByteTime = 0;
+
+void shim::setI2CByteTime(unsigned int us) { i2cByteTime = us; }
+
+SoftwareWire::SoftwareWire(uint8_t pinSDA, uint8_t pinSCL)
+  : address(0), txLength(0), rxLength(0), rxIndex(0) {
+  (void)pinSDA;
+  (void)pinSCL;
+}
+
+void SoftwareWire::begin(void) {}
+
+void SoftwareWire::beginTransmission(uint8_t slaveAddress) {
+
+  address = slaveAddress;
+  txLength = 0;
+}
+
+size_t SoftwareWire::write(uint8_t data) {
+
+  if(txLength >= SHIM_I2C_BUFFER)
+    return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t SoftwareWire::write(const uint8_t *data, size_t quantity) {
+
+  size_t written = 0;
+  for(size_t i = 0; i < quantity; i++) {
+    written += write(data[i]);
+  }
+  return written;
+}
+
+uint8_t SoftwareWire::endTransmission(void) {
+
+  uint8_t status = 4;   // "other error" if nobody listens
+  // Address and data bytes
+  clockMicros += (uint64_t)i2cByteTime * (txLength + 1);
+  if(i2cBackend)
+    status = i2cBackend->write(address, txBuffer, txLength);
+  txLength = 0;
+  return status;
+}
+
+uint8_t SoftwareWire::requestFrom(uint8_t slaveAddress, uint8_t quantity) {
+
+  if(quantity > SHIM_I2C_BUFFER)
+    quantity = SHIM_I2C_BUFFER;
+  rxIndex = 0;
+  rxLength = 0;
+  clockMicros += (uint64_t)i2cByteTime * (quantity + 1);
+  if(i2cBackend)
+    rxLength = i2cBackend->read(slaveAddress, rxBuffer, quantity);
+  return rxLength;
+}
+
+int SoftwareWire::available(void) { return rxLength - rxIndex; }
+
+int SoftwareWire::read(void) {
+
+  if(rxIndex < rxLength)
+    return rxBuffer[rxIndex++];
+  return -1;
+}
+
+//***************************
+// LCD
+//***************************
+LCD_LAUNCHPAD::LCD_LAUNCHPAD() : symbols(0), updates(0) { clear(); }
+
+void LCD_LAUNCHPAD::init(void) { clear(); }
+
+void LCD_LAUNCHPAD::clear(void) {
+
+  memset(text, ' ', LCD_DIGITS);
+  text[LCD_DIGITS] = '\0';
+  symbols = 0;
+}
+
+void LCD_LAUNCHPAD::showChar(char c, int position) {
+
+  if(position >= 0 && position < LCD_DIGITS)
+    text[position] = c;
+  updates++;
+}
+
+void LCD_LAUNCHPAD::showSymbol(int symbol, int on) {
+
+  if(on)
+    symbols |= (uint32_t)1 << symbol;
+  else
+    symbols &= ~((uint32_t)1 << symbol);
+}
+
+void LCD_LAUNCHPAD::displayText(const char *s, int position) {
+
+  clear();
+  for(int i = position; i < LCD_DIGITS && *s; i++) {
+    text[i] = *s++;
+  }
+  updates++;
+}
+
+void LCD_LAUNCHPAD::displayScrollText(const char *s, int wait) {
+
+  // Scrolling takes one step per character on the device
+  delay((unsigned long)wait * strlen(s));
+  displayText(s);
+}
+
+//*********************************************************
+// Text representation of the display content, digits
+// followed by the symbol mask, e.g. "  1234|00000c00"
+//*********************************************************
+std::string LCD_LAUNCHPAD::snapshot(void) const {
+
+  char mask[12];
+  snprintf(mask, sizeof(mask), "|%08x", (unsigned int)symbols);
+  return std::string(text) + mask;
+}
+
+//***************************
+// itoa
+//***************************
+char *itoa(int value, char *string, int radix) {
+
+  char digits[34];
+  int i = 0;
+  unsigned int magnitude = (value < 0 && radix == 10) ? -(unsigned int)value : (unsigned int)value;
+
+  do {
+    int digit = magnitude % radix;
+    digits[i++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    magnitude /= radix;
+  } while(magnitude);
+
+  char *p = string;
+  if(value < 0 && radix == 10)
+    *p++ = '-';
+  while(i > 0) {
+    *p++ = digits[--i];
+  }
+  *p = '\0';
+  return string;
+}
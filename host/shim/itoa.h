@@ -0,0 +1,13 @@
+/*
+ * itoa.h (host shim)
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#ifndef SHIM_ITOA_H_
+#define SHIM_ITOA_H_
+
+char *itoa(int value, char *string, int radix);
+
+#endif /* SHIM_ITOA_H_ */
@@ -0,0 +1,524 @@
+/*
+ * TimeSeriesFile.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <limits>
+
+#include "TimeSeriesFile.h"
+
+static_assert(sizeof(FileHeader) == 8, "FileHeader layout");
+static_assert(sizeof(ChannelIndex) == 24, "ChannelIndex layout");
+static_assert(sizeof(ChunkHeader) == 160, "ChunkHeader layout");
+static_assert(sizeof(ChunkRef) == 32, "ChunkRef layout");
+static_assert(sizeof(Trailer) == 16, "Trailer layout");
+
+//***************************
+// Zigzag/varint coding
+//***************************
+static inline uint64_t zigzag(int64_t value) {
+
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t value) {
+
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static inline void putVarint(std::vector<uint8_t> *out, uint64_t value) {
+
+  while(value >= 0x80) {
+    out->push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back((uint8_t)value);
+}
+
+// Stops at the last byte of a column (checked by open()),
+// overlong codes of a corrupt file don't shift past 63 bits
+static inline uint64_t getVarint(const uint8_t **p) {
+
+  uint64_t value = 0;
+  unsigned int shift = 0;
+  uint8_t byte;
+  do {
+    byte = *(*p)++;
+    value |= (uint64_t)(byte & 0x7F) << (shift & 63);
+    shift += 7;
+  } while(byte & 0x80);
+  return value;
+}
+
+int32_t Sample::channel(int c) const {
+
+  switch(c) {
+    case TS_SEQUENCE: return sequence;
+    case TS_CO2: return co2;
+    case TS_TVOC: return tvoc;
+    case TS_TEMPERATURE: return temperature;
+    case TS_HUMIDITY: return humidity;
+    default: return 0;
+  }
+}
+
+static void setChannel(Sample *sample, int c, int32_t value) {
+
+  switch(c) {
+    case TS_SEQUENCE: sample->sequence = (uint16_t)value; break;
+    case TS_CO2: sample->co2 = (uint16_t)value; break;
+    case TS_TVOC: sample->tvoc = (uint16_t)value; break;
+    case TS_TEMPERATURE: sample->temperature = (int16_t)value; break;
+    case TS_HUMIDITY: sample->humidity = (uint16_t)value; break;
+    default: break;
+  }
+}
+
+ChannelStats::ChannelStats()
+  : count(0), sum(0), min(std::numeric_limits<int32_t>::max()), max(std::numeric_limits<int32_t>::min()) {
+}
+
+void ChannelStats::add(const ChannelStats &other) {
+
+  count += other.count;
+  sum += other.sum;
+  if(other.min < min) min = other.min;
+  if(other.max > max) max = other.max;
+}
+
+void ChannelStats::add(int32_t value) {
+
+  count++;
+  sum += value;
+  if(value < min) min = value;
+  if(value > max) max = value;
+}
+
+//*********************************************************
+// Writer
+//*********************************************************
+TimeSeriesWriter::TimeSeriesWriter(size_t samplesPerChunk, size_t maxBufferedSamples)
+  : file(0), position(0), chunkSamples(samplesPerChunk), maxBuffered(maxBufferedSamples), buffered(0) {
+  // The reader rejects larger chunks
+  if(chunkSamples == 0 || chunkSamples > TS_CHUNK_SAMPLES)
+    chunkSamples = TS_CHUNK_SAMPLES;
+}
+
+TimeSeriesWriter::~TimeSeriesWriter() {
+
+  if(file)
+    close();
+}
+
+void TimeSeriesWriter::writeBytes(const void *data, size_t length) {
+
+  fwrite(data, 1, length, file);
+  position += length;
+}
+
+bool TimeSeriesWriter::open(const std::string &path) {
+
+  file = fopen(path.c_str(), "wb");
+  if(!file)
+    return false;
+
+  FileHeader header;
+  header.magic = TS_FILE_MAGIC;
+  header.version = TS_FILE_VERSION;
+  header.channels = TS_CHANNELS;
+  writeBytes(&header, sizeof(header));
+  return true;
+}
+
+//*********************************************************
+// Add a reading of a device, readings of one device must
+// be appended in time order. If too many readings are
+// buffered, all devices get a (shorter) chunk written.
+//*********************************************************
+void TimeSeriesWriter::append(uint32_t device, const Sample &sample) {
+
+  std::vector<Sample> &buffer = buffers[device];
+  buffer.push_back(sample);
+  buffered++;
+  if(buffer.size() >= chunkSamples)
+    flush(device);
+  else if(buffered >= maxBuffered)
+    flushAll();
+}
+
+void TimeSeriesWriter::flush(uint32_t device) {
+
+  std::vector<Sample> &buffer = buffers[device];
+  if(!buffer.empty()) {
+    writeChunk(device, buffer);
+    buffered -= buffer.size();
+    buffer.clear();
+  }
+}
+
+void TimeSeriesWriter::flushAll(void) {
+
+  std::unordered_map<uint32_t, std::vector<Sample> >::iterator it;
+  for(it = buffers.begin(); it != buffers.end(); ++it) {
+    flush(it->first);
+  }
+  buffers.clear();
+}
+
+void TimeSeriesWriter::writeChunk(uint32_t device, const std::vector<Sample> &samples) {
+
+  ChunkHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = TS_CHUNK_MAGIC;
+  header.device = device;
+  header.count = samples.size();
+  header.timeMin = samples[0].timestamp;
+  header.timeMax = samples[0].timestamp;
+
+  // Time column: first value, first delta, then delta-of-delta
+  std::vector<uint8_t> payload;
+  int64_t previous = 0, previousDelta = 0;
+  for(size_t i = 0; i < samples.size(); i++) {
+    int64_t t = samples[i].timestamp;
+    if(t < header.timeMin) header.timeMin = t;
+    if(t > header.timeMax) header.timeMax = t;
+    if(i == 0)
+      putVarint(&payload, zigzag(t));
+    else {
+      int64_t delta = t - previous;
+      putVarint(&payload, zigzag(delta - previousDelta));
+      previousDelta = delta;
+    }
+    previous = t;
+  }
+  header.timeSize = payload.size();
+
+  // Value columns: delta to the previous value
+  for(int c = 0; c < TS_CHANNELS; c++) {
+    ChannelStats stats;
+    ChannelIndex &column = header.channels[c];
+    column.offset = payload.size();
+    int32_t last = 0;
+    for(size_t i = 0; i < samples.size(); i++) {
+      int32_t value = samples[i].channel(c);
+      stats.add(value);
+      putVarint(&payload, zigzag((int64_t)value - last));
+      last = value;
+    }
+    column.size = payload.size() - column.offset;
+    column.min = stats.min;
+    column.max = stats.max;
+    column.sum = stats.sum;
+  }
+
+  // Keep the next header 8-byte aligned for in-place access
+  while(payload.size() % 8)
+    payload.push_back(0);
+  header.payloadSize = payload.size();
+
+  ChunkRef ref;
+  ref.offset = position;
+  ref.device = device;
+  ref.count = header.count;
+  ref.timeMin = header.timeMin;
+  ref.timeMax = header.timeMax;
+  index.push_back(ref);
+
+  writeBytes(&header, sizeof(header));
+  writeBytes(&payload[0], payload.size());
+  // On disk at once, a killed writer loses only buffered samples
+  fflush(file);
+}
+
+//*********************************************************
+// Write the buffered samples as (shorter) chunks, so they
+// are on disk if the writer doesn't get to close()
+//
+// return:  false on a write error
+//*********************************************************
+bool TimeSeriesWriter::sync(void) {
+
+  if(!file)
+    return false;
+  flushAll();
+  return fflush(file) == 0 && !ferror(file);
+}
+
+//*********************************************************
+// Write the buffered chunks and the chunk index
+//
+// return:  false on a write error
+//*********************************************************
+bool TimeSeriesWriter::close(void) {
+
+  if(!file)
+    return false;
+
+  flushAll();
+
+  Trailer trailer;
+  trailer.indexOffset = position;
+  trailer.chunkCount = index.size();
+  trailer.magic = TS_TRAILER_MAGIC;
+  if(!index.empty())
+    writeBytes(&index[0], index.size() * sizeof(ChunkRef));
+  writeBytes(&trailer, sizeof(trailer));
+  index.clear();
+
+  bool ok = !ferror(file);
+  ok = (fclose(file) == 0) && ok;
+  file = 0;
+  return ok;
+}
+
+//*********************************************************
+// Reader
+//*********************************************************
+TimeSeriesReader::TimeSeriesReader()
+  : base(0), length(0), refs(0), chunks(0), withoutTrailer(false), chunksDecoded(0) {
+}
+
+TimeSeriesReader::~TimeSeriesReader() {
+
+  close();
+}
+
+//*********************************************************
+// A chunk lies within [offset, end), 8-byte aligned, and
+// its columns within its payload. Every column ends with
+// the last byte of a varint, so decoding can't run past it.
+//*********************************************************
+static bool validChunk(const uint8_t *base, uint64_t offset, uint64_t end) {
+
+  if(offset < sizeof(FileHeader) || offset % 8 || offset > end || end - offset < sizeof(ChunkHeader))
+    return false;
+  const ChunkHeader &header = *(const ChunkHeader *)(base + offset);
+  if(header.magic != TS_CHUNK_MAGIC || header.count == 0 || header.count > TS_CHUNK_SAMPLES ||
+     header.payloadSize > end - offset - sizeof(ChunkHeader) ||
+     header.timeSize < header.count || header.timeSize > header.payloadSize)
+    return false;
+
+  const uint8_t *payload = (const uint8_t *)(&header + 1);
+  if(payload[header.timeSize - 1] & 0x80)
+    return false;
+  for(int c = 0; c < TS_CHANNELS; c++) {
+    const ChannelIndex &column = header.channels[c];
+    if(column.offset > header.payloadSize || column.size > header.payloadSize - column.offset ||
+       column.size < header.count || (payload[column.offset + column.size - 1] & 0x80))
+      return false;
+  }
+  return true;
+}
+
+//*********************************************************
+// Map a file and check its structure
+//
+// return:  false if the file is no valid .lpts file
+//*********************************************************
+bool TimeSeriesReader::open(const std::string &path) {
+
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  struct stat info;
+  if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader)) {
+    ::close(fd);
+    return false;
+  }
+  void *mapped = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(mapped == MAP_FAILED)
+    return false;
+
+  base = (const uint8_t *)mapped;
+  length = info.st_size;
+
+  const FileHeader *header = (const FileHeader *)base;
+  if(header->magic != TS_FILE_MAGIC || header->version != TS_FILE_VERSION) {
+    close();
+    return false;
+  }
+  madvise(mapped, length, MADV_WILLNEED);
+
+  // Everything is 8-byte aligned, so is a complete file
+  if(length < sizeof(FileHeader) + sizeof(Trailer) || length % 8 ||
+     ((const Trailer *)(base + length - sizeof(Trailer)))->magic != TS_TRAILER_MAGIC) {
+    scan();
+    return true;
+  }
+  const Trailer *trailer = (const Trailer *)(base + length - sizeof(Trailer));
+  if(trailer->indexOffset % 8 ||
+     trailer->indexOffset > length ||
+     trailer->indexOffset + (uint64_t)trailer->chunkCount * sizeof(ChunkRef) + sizeof(Trailer) != length) {
+    close();
+    return false;
+  }
+
+  refs = (const ChunkRef *)(base + trailer->indexOffset);
+  for(uint32_t i = 0; i < trailer->chunkCount; i++) {
+    const ChunkRef &ref = refs[i];
+    if(!validChunk(base, ref.offset, trailer->indexOffset)) {
+      close();
+      return false;
+    }
+    const ChunkHeader &chunk = *(const ChunkHeader *)(base + ref.offset);
+    if(chunk.device != ref.device || chunk.count != ref.count ||
+       chunk.timeMin != ref.timeMin || chunk.timeMax != ref.timeMax) {
+      close();
+      return false;
+    }
+  }
+  chunks = trailer->chunkCount;
+  return true;
+}
+
+//*********************************************************
+// Rebuild the index of a file without trailer from the
+// chunk headers, up to the first incomplete or damaged one
+//*********************************************************
+void TimeSeriesReader::scan(void) {
+
+  uint64_t offset = sizeof(FileHeader);
+
+  scanned.clear();
+  while(validChunk(base, offset, length)) {
+    const ChunkHeader &header = *(const ChunkHeader *)(base + offset);
+    ChunkRef ref;
+    ref.offset = offset;
+    ref.device = header.device;
+    ref.count = header.count;
+    ref.timeMin = header.timeMin;
+    ref.timeMax = header.timeMax;
+    scanned.push_back(ref);
+    offset += sizeof(ChunkHeader) + header.payloadSize;
+  }
+  refs = scanned.empty() ? 0 : &scanned[0];
+  chunks = scanned.size();
+  withoutTrailer = true;
+}
+
+void TimeSeriesReader::close(void) {
+
+  if(base)
+    munmap((void *)base, length);
+  base = 0;
+  length = 0;
+  refs = 0;
+  chunks = 0;
+  scanned.clear();
+  withoutTrailer = false;
+}
+
+const ChunkHeader &TimeSeriesReader::chunk(uint32_t i) const {
+
+  return *(const ChunkHeader *)(base + refs[i].offset);
+}
+
+void TimeSeriesReader::decodeTime(uint32_t i, int64_t *timestamps) const {
+
+  const ChunkHeader &header = chunk(i);
+  const uint8_t *p = (const uint8_t *)(&header + 1);
+  const uint8_t *end = p + header.timeSize;
+  int64_t t = 0, delta = 0;
+
+  for(uint32_t n = 0; n < header.count; n++) {
+    int64_t value = p < end ? unzigzag(getVarint(&p)) : 0;
+    if(n == 0)
+      t = value;
+    else {
+      delta += value;
+      t += delta;
+    }
+    timestamps[n] = t;
+  }
+  chunksDecoded++;
+}
+
+void TimeSeriesReader::decodeChannel(uint32_t i, int c, int32_t *values) const {
+
+  const ChunkHeader &header = chunk(i);
+  const uint8_t *p = (const uint8_t *)(&header + 1) + header.channels[c].offset;
+  const uint8_t *end = p + header.channels[c].size;
+  int64_t value = 0;
+
+  for(uint32_t n = 0; n < header.count; n++) {
+    if(p < end)
+      value += unzigzag(getVarint(&p));
+    values[n] = (int32_t)value;
+  }
+}
+
+void TimeSeriesReader::decode(uint32_t i, std::vector<Sample> *samples) const {
+
+  const ChunkHeader &header = chunk(i);
+  std::vector<int64_t> timestamps(header.count);
+  std::vector<int32_t> values(header.count);
+  size_t start = samples->size();
+
+  samples->resize(start + header.count);
+  decodeTime(i, &timestamps[0]);
+  for(uint32_t n = 0; n < header.count; n++) {
+    (*samples)[start + n].timestamp = timestamps[n];
+  }
+  for(int c = 0; c < TS_CHANNELS; c++) {
+    decodeChannel(i, c, &values[0]);
+    for(uint32_t n = 0; n < header.count; n++) {
+      setChannel(&(*samples)[start + n], c, values[n]);
+    }
+  }
+}
+
+//*********************************************************
+// Count, sum, min and max of a channel within [from, to]
+// Chunks inside the range are answered from their index,
+// only chunks crossing a range border are decoded.
+//
+// input:   c           channel (TS_xxx)
+//          from, to    time range in ms, inclusive
+//          anyDevice   false to select a single device
+//          device      device ID if anyDevice is false
+//
+// return:  aggregated statistics
+//*********************************************************
+ChannelStats TimeSeriesReader::aggregate(int c, int64_t from, int64_t to, bool anyDevice, uint32_t device) const {
+
+  ChannelStats result;
+  std::vector<int64_t> timestamps;
+  std::vector<int32_t> values;
+
+  for(uint32_t i = 0; i < chunks; i++) {
+    const ChunkRef &ref = refs[i];
+    if((!anyDevice && ref.device != device) || ref.timeMax < from || ref.timeMin > to)
+      continue;
+
+    const ChunkHeader &header = chunk(i);
+    if(ref.timeMin >= from && ref.timeMax <= to) {
+      ChannelStats part;
+      part.count = header.count;
+      part.sum = header.channels[c].sum;
+      part.min = header.channels[c].min;
+      part.max = header.channels[c].max;
+      result.add(part);
+      continue;
+    }
+
+    timestamps.resize(header.count);
+    values.resize(header.count);
+    decodeTime(i, &timestamps[0]);
+    decodeChannel(i, c, &values[0]);
+    for(uint32_t n = 0; n < header.count; n++) {
+      if(timestamps[n] >= from && timestamps[n] <= to)
+        result.add(values[n]);
+    }
+  }
+  return result;
+}
@@ -0,0 +1,169 @@
+/*
+ * TimeSeriesFile.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Compressed columnar file for collected readings (".lpts").
+ *
+ *   [FileHeader]
+ *   [ChunkHeader][time column][sequence column]...[humidity column]
+ *   ...
+ *   [ChunkRef * chunkCount][Trailer]
+ *
+ * A chunk holds up to TS_CHUNK_SAMPLES readings of one device in
+ * time order. Timestamps are stored as delta-of-delta, all other
+ * channels as delta, both zigzag/varint coded. The values keep
+ * the firmware's integer units, so a round trip is bit-exact.
+ * Each chunk header carries count, min, max and sum per channel,
+ * which answers most aggregates without decoding the columns.
+ * All structures are little-endian and read in place from a
+ * memory-mapped file. open() checks every chunk and column
+ * against the file size first, a damaged file is rejected.
+ *
+ * Every chunk goes to the file as soon as it is complete, the
+ * index only with close(). A file without a trailer (the writer
+ * was killed) is read by scanning the chunk headers up to the
+ * first incomplete chunk.
+ */
+
+#ifndef TIMESERIESFILE_H_
+#define TIMESERIESFILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define TS_FILE_MAGIC         0x5354504C    // "LPTS"
+#define TS_CHUNK_MAGIC        0x4B4E4843    // "CHNK"
+#define TS_TRAILER_MAGIC      0x4554504C    // "LPTE"
+#define TS_FILE_VERSION       1
+#define TS_CHUNK_SAMPLES      1024
+#define TS_MAX_BUFFERED       (4UL << 20)   // samples held by the writer
+
+// Value channels (time is stored separately)
+enum {
+  TS_SEQUENCE, TS_CO2, TS_TVOC, TS_TEMPERATURE, TS_HUMIDITY, TS_CHANNELS
+};
+
+struct Sample {
+  int64_t timestamp;      // ms since 1970 (UTC)
+  uint16_t sequence;
+  uint16_t co2;           // ppm
+  uint16_t tvoc;          // ppb
+  int16_t temperature;    // 1/100 degree Celsius
+  uint16_t humidity;      // 1/100 percent
+
+  int32_t channel(int c) const;
+};
+
+struct FileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t channels;
+};
+
+struct ChannelIndex {
+  int32_t min;
+  int32_t max;
+  int64_t sum;
+  uint32_t offset;        // column start, relative to the chunk payload
+  uint32_t size;          // column size in bytes
+};
+
+struct ChunkHeader {
+  uint32_t magic;
+  uint32_t device;
+  uint32_t count;
+  uint32_t payloadSize;   // bytes following this header
+  int64_t timeMin;
+  int64_t timeMax;
+  uint32_t timeSize;      // time column size, the column starts the payload
+  uint32_t reserved;
+  ChannelIndex channels[TS_CHANNELS];
+};
+
+struct ChunkRef {
+  uint64_t offset;        // of the ChunkHeader
+  uint32_t device;
+  uint32_t count;
+  int64_t timeMin;
+  int64_t timeMax;
+};
+
+struct Trailer {
+  uint64_t indexOffset;
+  uint32_t chunkCount;
+  uint32_t magic;
+};
+
+struct ChannelStats {
+  uint64_t count;
+  int64_t sum;
+  int32_t min;
+  int32_t max;
+
+  ChannelStats();
+  void add(const ChannelStats &other);
+  void add(int32_t value);
+};
+
+//***************************
+// Appends readings, one chunk per device at a time
+//***************************
+class TimeSeriesWriter {
+  private:
+    FILE *file;
+    uint64_t position;
+    size_t chunkSamples;
+    size_t maxBuffered;
+    size_t buffered;
+    std::unordered_map<uint32_t, std::vector<Sample> > buffers;
+    std::vector<ChunkRef> index;
+    void writeBytes(const void *data, size_t length);
+    void writeChunk(uint32_t device, const std::vector<Sample> &samples);
+
+  public:
+    explicit TimeSeriesWriter(size_t samplesPerChunk = TS_CHUNK_SAMPLES, size_t maxBufferedSamples = TS_MAX_BUFFERED);
+    ~TimeSeriesWriter();
+    bool open(const std::string &path);
+    void append(uint32_t device, const Sample &sample);
+    void flush(uint32_t device);
+    void flushAll(void);
+    bool sync(void);
+    bool close(void);
+};
+
+//***************************
+// Memory-mapped read access
+//***************************
+class TimeSeriesReader {
+  private:
+    const uint8_t *base;
+    size_t length;
+    const ChunkRef *refs;
+    uint32_t chunks;
+    std::vector<ChunkRef> scanned;    // index of a file without trailer
+    bool withoutTrailer;
+    void scan(void);
+
+  public:
+    TimeSeriesReader();
+    ~TimeSeriesReader();
+    bool open(const std::string &path);
+    void close(void);
+    uint32_t chunkCount(void) const { return chunks; }
+    bool recovered(void) const { return withoutTrailer; }
+    const ChunkRef &chunkRef(uint32_t i) const { return refs[i]; }
+    const ChunkHeader &chunk(uint32_t i) const;
+    void decodeTime(uint32_t i, int64_t *timestamps) const;
+    void decodeChannel(uint32_t i, int c, int32_t *values) const;
+    void decode(uint32_t i, std::vector<Sample> *samples) const;
+    ChannelStats aggregate(int c, int64_t from, int64_t to, bool anyDevice, uint32_t device) const;
+    mutable std::atomic<size_t> chunksDecoded;    // chunks the index could not answer, any thread
+};
+
+#endif /* TIMESERIESFILE_H_ */
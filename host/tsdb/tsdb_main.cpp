@@ -0,0 +1,138 @@
+/*
+ * tsdb_main.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: HaagS
+ *
+ * Inspects .lpts files.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -Ihost/tsdb -o lp_tsdb host/tsdb/tsdb_main.cpp host/tsdb/TimeSeriesFile.cpp
+ *
+ * Usage:
+ *   lp_tsdb info  file.lpts
+ *   lp_tsdb dump  file.lpts [-d device] [-f from] [-t to]
+ *   lp_tsdb stats file.lpts channel [-d device] [-f from] [-t to]
+ *
+ *   channel   sequence, co2, tvoc, temperature or humidity
+ *   device    hexadecimal device ID
+ *   from, to  ms since 1970, inclusive
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits>
+
+#include "TimeSeriesFile.h"
+
+static const char *channelNames[TS_CHANNELS] = {
+  "sequence", "co2", "tvoc", "temperature", "humidity"
+};
+
+static int usage(const char *name) {
+
+  fprintf(stderr, "usage: %s info|dump|stats file.lpts [channel] [-d device] [-f from] [-t to]\n", name);
+  return 2;
+}
+
+static void info(const TimeSeriesReader &reader, const char *path) {
+
+  uint64_t samples = 0, payload = 0;
+  int64_t first = std::numeric_limits<int64_t>::max(), last = std::numeric_limits<int64_t>::min();
+  uint64_t columnBytes[TS_CHANNELS] = {0};
+  uint64_t timeBytes = 0;
+
+  for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+    const ChunkHeader &header = reader.chunk(i);
+    samples += header.count;
+    payload += sizeof(ChunkHeader) + header.payloadSize;
+    timeBytes += header.timeSize;
+    for(int c = 0; c < TS_CHANNELS; c++) {
+      columnBytes[c] += header.channels[c].size;
+    }
+    if(header.timeMin < first) first = header.timeMin;
+    if(header.timeMax > last) last = header.timeMax;
+  }
+
+  printf("%s: %u chunks, %llu samples\n", path, reader.chunkCount(), (unsigned long long)samples);
+  if(reader.recovered())
+    printf("no index (writer didn't close the file), chunks found by scanning\n");
+  if(samples == 0)
+    return;
+  printf("time range: %lld .. %lld ms\n", (long long)first, (long long)last);
+  printf("bytes per sample: %.2f (time %.2f", (double)payload / samples, (double)timeBytes / samples);
+  for(int c = 0; c < TS_CHANNELS; c++) {
+    printf(", %s %.2f", channelNames[c], (double)columnBytes[c] / samples);
+  }
+  printf(")\n");
+}
+
+int main(int argc, char **argv) {
+
+  if(argc < 3)
+    return usage(argv[0]);
+
+  const char *command = argv[1];
+  const char *path = argv[2];
+  int channel = -1;
+  bool anyDevice = true;
+  uint32_t device = 0;
+  int64_t from = std::numeric_limits<int64_t>::min();
+  int64_t to = std::numeric_limits<int64_t>::max();
+
+  for(int i = 3; i < argc; i++) {
+    if(!strcmp(argv[i], "-d") && i + 1 < argc) {
+      device = strtoul(argv[++i], 0, 16);
+      anyDevice = false;
+    }
+    else if(!strcmp(argv[i], "-f") && i + 1 < argc) from = strtoll(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc) to = strtoll(argv[++i], 0, 10);
+    else {
+      for(int c = 0; c < TS_CHANNELS; c++) {
+        if(!strcmp(argv[i], channelNames[c]))
+          channel = c;
+      }
+      if(channel < 0)
+        return usage(argv[0]);
+    }
+  }
+
+  TimeSeriesReader reader;
+  if(!reader.open(path)) {
+    fprintf(stderr, "%s is no valid .lpts file\n", path);
+    return 2;
+  }
+
+  if(!strcmp(command, "info")) {
+    info(reader, path);
+  }
+  else if(!strcmp(command, "dump")) {
+    std::vector<Sample> samples;
+    printf("device,sequence,timestamp,co2,tvoc,temperature,humidity\n");
+    for(uint32_t i = 0; i < reader.chunkCount(); i++) {
+      const ChunkRef &ref = reader.chunkRef(i);
+      if((!anyDevice && ref.device != device) || ref.timeMax < from || ref.timeMin > to)
+        continue;
+      samples.clear();
+      reader.decode(i, &samples);
+      for(size_t n = 0; n < samples.size(); n++) {
+        const Sample &s = samples[n];
+        if(s.timestamp < from || s.timestamp > to)
+          continue;
+        printf("%08x,%u,%lld,%u,%u,%d,%u\n", (unsigned int)ref.device, s.sequence, (long long)s.timestamp,
+               s.co2, s.tvoc, s.temperature, s.humidity);
+      }
+    }
+  }
+  else if(!strcmp(command, "stats") && channel >= 0) {
+    ChannelStats stats = reader.aggregate(channel, from, to, anyDevice, device);
+    printf("%s: count %llu", channelNames[channel], (unsigned long long)stats.count);
+    if(stats.count)
+      printf(", min %d, max %d, mean %.2f", stats.min, stats.max, (double)stats.sum / stats.count);
+    printf(" (%u of %u chunks decoded)\n", (unsigned int)reader.chunksDecoded, reader.chunkCount());
+  }
+  else return usage(argv[0]);
+
+  return 0;
+}
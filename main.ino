@@ -3,27 +3,85 @@
 #include "SGP30.h"
 #include "SHT21.h"
 #include "GUI.h"
+#include "Telemetry.h"
+#include "I2CTrace.h"
+#include "FRAM.h"
+#include "Scheduler.h"
+#include "Burst.h"
+#include "I2CBus.h"
+#include "Watchdog.h"
+#include "Config.h"
+#include "RecordLog.h"
+#include "Energy.h"
 
 /********************************************
- * Define the interval of measurements here!!
- * (value in milliseconds)
+ * The intervals of measurements, the SHT21
+ * resolution, filter and telemetry are stored
+ * in FRAM and set over the serial interface
+ * (host/config). Defaults are in Config.h.
  ********************************************/
-#define MEAS_INTERVAL  500
 /********************************************
  * Uncomment this line if you want to print
  * information in serial monitor.
  * Increases required RAM and is slower
  ********************************************/
 //#define DEBUG_MODE
+/********************************************
+ * Uncomment this line to send every reading
+ * as binary telemetry frame (see Telemetry.h)
+ * to the host collector (host/collector).
+ * Also enables host commands, e.g. the raw
+ * signal burst of the SGP30 (host/burst).
+ ********************************************/
+//#define TELEMETRY
+/********************************************
+ * I2C transaction capture (I2C_TRACE) is
+ * selected in I2CTrace.h
+ ********************************************/
+#if defined(DEBUG_MODE) && (defined(I2C_TRACE) || defined(TELEMETRY))
+#error "DEBUG_MODE can't be combined with I2C_TRACE or TELEMETRY."
+#endif
 
 // Defines for I2C library
 #define SDA_PIN P8_3
 #define SCL_PIN P8_2
-SoftwareWire Wire(SDA_PIN, SCL_PIN);
+I2CBus Wire(SDA_PIN, SCL_PIN);
 
 #define LED_RED     P1_7
 #define LED_GREEN   P1_6
 
+// Scheduler tasks
+enum {
+  TASK_BOOT, TASK_SGP30, TASK_SHT21, TASK_ANIMATION, TASK_ERROR, TASK_BURST, TASK_DUMP,
+  TASK_RECOVERY, TASK_EXPORT, TASK_ENERGY
+};
+// States of the boot sequence
+enum {
+  BOOT_RESET, BOOT_SELFTEST, BOOT_INIT, BOOT_START, BOOT_DONE, BOOT_FAILED
+};
+// States of the SHT21 measurement
+enum {
+  SHT21_START, SHT21_HUMIDITY, SHT21_TEMPERATURE
+};
+
+#define ANIMATION_INTERVAL    250
+#define ERROR_BLINK_INTERVAL  200
+#define BURST_DUMP_INTERVAL   50        // one frame takes 46 ms at 9600 baud
+#define SGP30_RETRY_INTERVAL  10000     // boot again after a failed self-test
+#define SGP30_MAX_ERRORS      3         // wrong checksums in a row
+#define SHT21_MAX_ERRORS      3         // wrong checksums in a row
+
+/********************************************
+ * I2C bus recovery
+ * A stuck bus is cleared (see I2CBus.h) and the
+ * sensors are reset one by one, a few ms later
+ * the measurements continue. Only if the lines
+ * stay low, the watchdog resets the board.
+ ********************************************/
+#define RECOVERY_RETRY_INTERVAL 100     // ms, times the attempt
+#define RECOVERY_MAX_ATTEMPTS   5
+#define WATCHDOG_TIMEOUT        4       // s
+
 //************** Global Variables ****************
   uint8_t SHT21_CRC = 0;
   unsigned long long SGP30_serialID = 0;
@@ -41,20 +99,43 @@ SoftwareWire Wire(SDA_PIN, SCL_PIN);
   volatile boolean rightButton = false;
   boolean show_max = false;
   uint8_t screen = 1; // start at CO2 screen
+
+  uint8_t bootState = BOOT_RESET;
+  uint8_t sht21State = SHT21_START;
+  unsigned long sgp30InitTime = 0;
+  unsigned long sgp30CycleStart = 0;
+  unsigned long sht21CycleStart = 0;
+  boolean co2Valid = false;       // SGP30 warm-up finished
+  boolean climateValid = false;   // SHT21 measured since reset
+  uint8_t animationStep = 0;
+  boolean generalCallReset = false; // in this boot sequence
+  uint8_t sgp30Errors = 0;
+  uint8_t sht21Errors = 0;
+  uint8_t recoveryAttempts = 0;
+  unsigned long maxWindowStart = 0;
+  unsigned long logTime = 0;
+  uint8_t exportBaud = LOG_BAUD_9600;
+  uint8_t telemetryCount = 0;
+  // Configuration, used in place from FRAM
+  const ConfigBlock *config = 0;
+  // Values stored before the reset (0 = none)
+  const FRAMReading *storedReading = 0;
   
   // Create C++ objects
   SGP30 sgp30;
   SHT21 sht21;
   CRC crc;
+  Telemetry telemetry;
   LCD_LAUNCHPAD lcd;
   GUI gui;
+  Scheduler scheduler;
+  Burst burst;
+  RecordLog recordLog;
+  Energy energy;
 //*****************************************
 
 void setup() {
 
-  lcd.clear();
-  lcd.displayScrollText("Initializing", 100);
-  
   //********** Pin configuration ***********
   pinMode(LED_RED, OUTPUT);
   pinMode(LED_GREEN, OUTPUT);
@@ -65,53 +146,292 @@ void setup() {
   attachInterrupt(PUSH1, _button1ISR, FALLING);  
   attachInterrupt(PUSH2, _button2ISR, FALLING);
 
-#ifdef DEBUG_MODE
+#if defined(DEBUG_MODE) || defined(I2C_TRACE) || defined(TELEMETRY)
   // Initialize Console
-  Serial.begin(9600);
+  Serial.begin(TELEMETRY_BAUD);
 #endif
   // Initialize I2C
   Wire.begin();
   // Initialize LCD
   lcd.init();
-
-  delay(1000);
+  lcd.clear();
 
 //*****************************************
 
   // Create the CRC look-up table
   crc.Init();
+  config = Config::begin();
+  screen = config->screen;
+  energy.begin();
+
+  // Show the values of the last reset until the sensors deliver
+  storedReading = FRAM::lastReading();
+  if(storedReading) {
+    SGP30_CO2 = storedReading->co2;
+    SGP30_TVOC = storedReading->tvoc;
+    temperature = storedReading->temperature / 100.0;
+    humidity = storedReading->humidity / 100.0;
+  }
+  showValues();
+
+  // Everything else runs in the scheduler, see loop()
+  scheduler.setTask(TASK_BOOT, bootTask);
+  scheduler.setTask(TASK_SGP30, sgp30Task);
+  scheduler.setTask(TASK_SHT21, sht21Task);
+  scheduler.setTask(TASK_ANIMATION, animationTask);
+  scheduler.setTask(TASK_ERROR, errorTask);
+  scheduler.setTask(TASK_RECOVERY, recoveryTask);
+  scheduler.setTask(TASK_ENERGY, energyTask);
+#ifdef TELEMETRY
+  scheduler.setTask(TASK_BURST, burstTask);
+  scheduler.setTask(TASK_DUMP, dumpTask);
+  scheduler.setTask(TASK_EXPORT, exportTask);
+#endif
+  scheduler.schedule(TASK_BOOT, 0);
+  // SHT21 needs 15 ms after power-up
+  scheduler.scheduleAt(TASK_SHT21, SHT21_RESET_TIME);
+  scheduler.schedule(TASK_ANIMATION, 0);
+  scheduler.schedule(TASK_ENERGY, ENERGY_REPORT_INTERVAL);
+
+  Watchdog::begin(WATCHDOG_TIMEOUT);
+}
+
+void loop() {
+
+  unsigned long wait = scheduler.run();
+
+  // Failed transactions in a row: clear the bus and
+  // reset the sensors
+  if(!Wire.isHealthy())
+    startRecovery();
+  // No kick if the bus can't be cleared
+  if(recoveryAttempts < RECOVERY_MAX_ATTEMPTS)
+    Watchdog::kick();
+#ifdef TELEMETRY
+  handleCommands();
+#endif
 
-  // Reset CO2 sensor because of undefined values after hardware reset
-  sgp30.softReset();
-  delay(500);
-  // Self-test (sensor should return 0xD400)
-  // Blink red LED if test failed
-  if(sgp30.isInitialised() == false) {
-    while(1) {
-      digitalWrite(LED_RED, LOW);
-      delay(200);
+  // Show maximum values if left button is pressed
+  if(leftButton && !rightButton) {
+    if(show_max)
+      show_max = false;
+    else
+      show_max = true;
+    leftButton = false;
+    showValues();
+    // Re-enable left button interrupt
+    attachInterrupt(PUSH1, _button1ISR, FALLING);
+  }
+  //Switch to next screen if right button is pressed
+  if(rightButton && !leftButton) {
+    if(screen < 3)
+      screen++;
+    else
+      screen = 1;
+    rightButton = false;
+    showValues();
+    // Re-enable right button interrupt
+    attachInterrupt(PUSH2, _button2ISR, FALLING);
+  }
+  // Delete maximum values if right button is held down
+  if(rightButton && leftButton) {
+    temperature_max = 0;
+    humidity_max = 0;
+    CO2_max = 0;
+    rightButton = false;
+    leftButton = false;
+   
+    // Wait until buttons are released
+    while(!digitalRead(PUSH1) && !digitalRead(PUSH2)) {
+      Watchdog::kick();
+    }
+    // Re-enable left and right button interrupt
+    attachInterrupt(PUSH1, _button1ISR, FALLING);
+    attachInterrupt(PUSH2, _button2ISR, FALLING);
+  }
+
+  // Low power mode until the next task is due, buttons wake up
+  if(wait > 0 && !leftButton && !rightButton)
+    energy.sleep(wait);
+}
+
+//*********************************************************
+// Boot sequence of the SGP30
+// Reset (0.6 ms), self-test (220 ms) and initialization
+// (10 ms), each step waits only for the time of the
+// command table in SGP30.cpp.
+// After a bus recovery it starts at the self-test, the
+// general call reset is sent only if that fails. A
+// sensor that fails both is tried again every 10 s.
+//*********************************************************
+void bootTask() {
+
+  uint16_t result = 0;
+
+  switch(bootState) {
+    case BOOT_FAILED:
+      scheduler.cancel(TASK_ERROR);
       digitalWrite(LED_RED, HIGH);
-      delay(200);
+      // fall through
+    case BOOT_RESET:
+      // Reset CO2 sensor because of undefined values after hardware reset
+      sgp30.softReset();
+      generalCallReset = true;
+      bootState = BOOT_SELFTEST;
+      scheduler.schedule(TASK_BOOT, SGP30_RESET_TIME);
+      break;
+    case BOOT_SELFTEST:
+      bootState = BOOT_INIT;
+      scheduler.schedule(TASK_BOOT, sgp30.start(SGP30_CMD_MEASURE_TEST));
+      break;
+    case BOOT_INIT:
+      // Self-test (sensor should return 0xD400)
+      // Blink red LED if test failed
+      if(!sgp30.finish(&result) || result != SGP30_SELFTEST_OK) {
+        if(!generalCallReset) {
+          bootState = BOOT_RESET;
+          scheduler.schedule(TASK_BOOT, 0);
+          break;
+        }
+        Serial.println("ERROR SGP30: Sensor is not initialised correctly");
+        bootState = BOOT_FAILED;
+        scheduler.cancel(TASK_ANIMATION);
+        scheduler.schedule(TASK_ERROR, 0);
+        scheduler.schedule(TASK_BOOT, SGP30_RETRY_INTERVAL);
+        showValues();
+        break;
+      }
+#ifdef TELEMETRY
+      // Identify this board by the SGP30 serial ID
+      if(!SGP30_serialID) {
+        SGP30_serialID = sgp30.getSerialID();
+        telemetry.begin((uint32_t)SGP30_serialID);
+      }
+#endif
+      // Initialize CO2 and TVOC measurement
+      bootState = BOOT_START;
+      scheduler.schedule(TASK_BOOT, sgp30.start(SGP30_CMD_INIT_AIR_QUALITY));
+      break;
+    case BOOT_START:
+      sgp30.finish(0);
+      sgp30InitTime = millis();
+      sgp30Errors = 0;
+      bootState = BOOT_DONE;
+      scheduler.schedule(TASK_SGP30, 0);
+      if(!scheduler.isScheduled(TASK_ANIMATION))
+        scheduler.schedule(TASK_ANIMATION, 0);
+      break;
+    default: break;
+  }
+}
+
+//*********************************************************
+// CO2 and TVOC measurement, once per second
+// Starts measure_air_quality and comes back when the
+// result is due (12 ms).
+//*********************************************************
+void sgp30Task() {
+
+  uint16_t words[2];
+
+  if(sgp30.pendingCommand() == SGP30_CMD_MEASURE_AIR_QUALITY) {
+    // Read CO2 sensor
+    if(sgp30.finish(words)) {
+      boolean first = (SGP30_CO2 == 0);
+      SGP30_CO2 = co2Valid ? lowPassInt(SGP30_CO2, words[0]) : words[0];
+      SGP30_TVOC = co2Valid ? lowPassInt(SGP30_TVOC, words[1]) : words[1];
+      if(first)
+        showValues();
+
+      // Sensor returns 400 ppm/ 0 ppb during the first 15 s
+      if(!co2Valid && (sgp30CycleStart - sgp30InitTime >= SGP30_WARMUP_TIME)) {
+        co2Valid = true;
+        storedReading = 0;
+      }
+      // If value is >40000, measurement was incorrect
+      if(co2Valid && (SGP30_CO2 > CO2_max) && (SGP30_CO2 < 40000))
+        CO2_max = SGP30_CO2;
+      sgp30Errors = 0;
+    }
+    else if(++sgp30Errors >= SGP30_MAX_ERRORS) {
+      startRecovery();
+      return;
     }
+    scheduler.scheduleAt(TASK_SGP30, sgp30CycleStart + config->sgp30Interval);
+    return;
+  }
+
+  // Another command is still running (burst)
+  if(sgp30.isBusy()) {
+    scheduler.schedule(TASK_SGP30, sgp30.dueIn());
+    return;
   }
-  // Initialize CO2 and TVOC measurement
-  sgp30.initializeMeasurement();
+  sgp30CycleStart = millis();
+  scheduler.schedule(TASK_SGP30, sgp30.start(SGP30_CMD_MEASURE_AIR_QUALITY));
 }
 
-void loop() {
+//*********************************************************
+// Humidity and temperature measurement, display update
+// Triggers a conversion and comes back when it's done.
+//*********************************************************
+void sht21Task() {
+
+  float value;
 
-  // Read CO2 sensor
-  sgp30.getMeasurementData(&SGP30_CO2, &SGP30_TVOC);
-  // Read humidity and temperature sensor
-  humidity = sht21.readSensor(HUMIDITY);
-  temperature = sht21.readSensor(TEMP);
+  switch(sht21State) {
+    case SHT21_START:
+      // Resolution of the configuration, again after a reset
+      if(sht21.getResolution() != config->sht21Resolution)
+        sht21.setResolution(config->sht21Resolution);
+      sht21CycleStart = millis();
+      scheduler.schedule(TASK_SHT21, sht21.startMeasurement(HUMIDITY));
+      sht21State = SHT21_HUMIDITY;
+      return;
+    case SHT21_HUMIDITY:
+      // Keep the last value if the transaction or the checksum
+      // failed, only the checksums count here (bus see loop())
+      if(!sht21.readMeasurement(HUMIDITY, &value)) {
+        if(!Wire.getFailures() && ++sht21Errors >= SHT21_MAX_ERRORS) {
+          startRecovery();
+          return;
+        }
+      }
+      else if(!Wire.getFailures()) {
+        humidity = climateValid ? lowPass(humidity, value) : value;
+        sht21Errors = 0;
+      }
+      scheduler.schedule(TASK_SHT21, sht21.startMeasurement(TEMP));
+      sht21State = SHT21_TEMPERATURE;
+      return;
+    case SHT21_TEMPERATURE:
+      if(!sht21.readMeasurement(TEMP, &value)) {
+        if(!Wire.getFailures() && ++sht21Errors >= SHT21_MAX_ERRORS) {
+          startRecovery();
+          return;
+        }
+      }
+      else if(!Wire.getFailures()) {
+        temperature = climateValid ? lowPass(temperature, value) : value;
+        climateValid = true;
+        sht21Errors = 0;
+      }
+      sht21State = SHT21_START;
+      scheduler.scheduleAt(TASK_SHT21, sht21CycleStart + config->sht21Interval);
+      break;
+    default: return;
+  }
+
+  // Maximal values of the last config->maxWindow minutes
+  if(config->maxWindow && millis() - maxWindowStart >= config->maxWindow * 60000UL) {
+    temperature_max = 0;
+    humidity_max = 0;
+    CO2_max = 0;
+    maxWindowStart = millis();
+  }
 
   // Save maximal values
   if(temperature > temperature_max)
     temperature_max = temperature;
-  // If value is >40000, measurement was incorrect
-  if((SGP30_CO2 > CO2_max) && (SGP30_CO2 < 40000))
-    CO2_max = SGP30_CO2;
   if(humidity > humidity_max)
     humidity_max = humidity;
 
@@ -125,15 +445,369 @@ void loop() {
   Serial.print("TVOC: ");
   Serial.println(SGP30_TVOC);
 #endif
+#ifdef TELEMETRY
+  if(bootState == BOOT_DONE && config->telemetryMode == CONFIG_TELEMETRY_READINGS &&
+     ++telemetryCount >= config->telemetryDivider) {
+    telemetryCount = 0;
+    telemetry.sendReading(SGP30_CO2, SGP30_TVOC, temperature, humidity);
+  }
+#endif
+
+  // Keep the stored CO2 value until the SGP30 is warmed up
+  if(co2Valid)
+    FRAM::saveReading(SGP30_CO2, SGP30_TVOC,
+                      Telemetry::toCentiUnits(temperature), Telemetry::toCentiUnits(humidity));
+  else if(storedReading)
+    FRAM::saveReading(storedReading->co2, storedReading->tvoc,
+                      Telemetry::toCentiUnits(temperature), Telemetry::toCentiUnits(humidity));
+
+  // One record every config->logInterval minutes
+  if(config->logInterval && climateValid && millis() - logTime >= config->logInterval * 60000UL) {
+    logTime = millis();
+    if(co2Valid || !storedReading)
+      recordLog.append(SGP30_CO2, SGP30_TVOC,
+                       Telemetry::toCentiUnits(temperature), Telemetry::toCentiUnits(humidity));
+    else
+      recordLog.append(storedReading->co2, storedReading->tvoc,
+                       Telemetry::toCentiUnits(temperature), Telemetry::toCentiUnits(humidity));
+  }
+
+  showValues();
+}
+
+//*********************************************************
+// Low-pass of the measured values
+// new = old + (value - old) / 2^config->filterShift
+//*********************************************************
+float lowPass(float filtered, float value) {
+
+  return filtered + (value - filtered) / (1 << config->filterShift);
+}
+
+unsigned int lowPassInt(unsigned int filtered, unsigned int value) {
+
+  return filtered + ((long)value - (long)filtered) / (1 << config->filterShift);
+}
+
+//*********************************************************
+// Boot indication without blocking
+// Scrolls "Initializing" while there is no CO2 value to
+// show, blinks the heart while the SGP30 warms up.
+//*********************************************************
+void animationTask() {
+
+  if(co2Valid) {
+    showValues();
+    return;
+  }
+  if(screen == SCREEN_CO2 && !show_max && SGP30_CO2 == 0 && !storedReading) {
+    const char text[] = "INITIALIZING      ";
+    for(uint8_t i = 0; i < 6; i++) {
+      lcd.showChar(text[(animationStep + i) % (sizeof(text) - 1)], i);
+    }
+  }
+  else
+    lcd.showSymbol(LCD_SEG_HEART, animationStep & 1);
+  animationStep++;
+  scheduler.schedule(TASK_ANIMATION, ANIMATION_INTERVAL);
+}
+
+//*********************************************************
+// Energy accounting (see Energy.h)
+// Collects the active times of the drivers, often enough
+// for the I2C time not to wrap around, and reports the
+// average current. A burst allows no serial traffic, its
+// report is left out, the next one covers the time.
+//*********************************************************
+void energyTask() {
+
+  energy.update(Wire.getBusyTime(), sht21.getConversionTime(), sgp30.getHeaterTime());
+#ifdef TELEMETRY
+  if(!burst.isSampling()) {
+    uint8_t payload[ENERGY_REPORT_SIZE];
+    telemetry.sendFrame(TELEMETRY_FRAME_ENERGY, payload, energy.encodeReport(payload));
+  }
+#endif
+#ifdef DEBUG_MODE
+  const char *names[ENERGY_COMPONENTS] = {"CPU", "I2C", "SHT21", "SGP30", "LCD"};
+  Serial.print("Energy after ");
+  Serial.print(energy.getElapsed());
+  Serial.println(" ms:");
+  for(uint8_t i = 0; i < ENERGY_COMPONENTS; i++) {
+    Serial.print(names[i]);
+    Serial.print(" active ");
+    Serial.print(energy.getActive(i));
+    Serial.print(" ms, ");
+    Serial.print(energy.averageCurrent(i) / 1000.0, 3);
+    Serial.println(" uAh/h");
+  }
+  Serial.print("Total: ");
+  Serial.print(energy.averageCurrent() / 1000.0, 3);
+  Serial.println(" uAh/h");
+#endif
+  scheduler.schedule(TASK_ENERGY, ENERGY_REPORT_INTERVAL);
+}
+
+//*********************************************************
+// Blink red LED, the SGP30 failed the self-test
+//*********************************************************
+void errorTask() {
+
+  digitalWrite(LED_RED, !digitalRead(LED_RED));
+  scheduler.schedule(TASK_ERROR, ERROR_BLINK_INTERVAL);
+}
+
+//*********************************************************
+// Start the bus recovery once
+//*********************************************************
+void startRecovery() {
+
+  if(!scheduler.isScheduled(TASK_RECOVERY))
+    scheduler.schedule(TASK_RECOVERY, 0);
+}
+
+//*********************************************************
+// Bring the I2C bus and the sensors back without reset
+// Clears the bus, sends the addressed soft reset to the
+// SHT21 and initializes the SGP30 again (self-test and
+// init_air_quality, see bootTask). The SGP30 warms up
+// again, meanwhile the display shows the last stored CO2
+// value.
+//*********************************************************
+void recoveryTask() {
+
+#ifdef TELEMETRY
+  // A running burst is dumped as it is
+  if(burst.isSampling()) {
+    scheduler.cancel(TASK_BURST);
+    burst.stop();
+    stopBurst();
+  }
+#endif
+  // Nothing else uses the bus until it's cleared
+  scheduler.cancel(TASK_BOOT);
+  scheduler.cancel(TASK_SGP30);
+  scheduler.cancel(TASK_SHT21);
+
+  if(!Wire.clear()) {
+    // Still stuck, the watchdog resets the board after
+    // RECOVERY_MAX_ATTEMPTS
+    if(recoveryAttempts < RECOVERY_MAX_ATTEMPTS)
+      recoveryAttempts++;
+    scheduler.schedule(TASK_RECOVERY, RECOVERY_RETRY_INTERVAL * recoveryAttempts);
+    return;
+  }
+  recoveryAttempts = 0;
+  Wire.resetFailures();
+
+  // SHT21 starts a new cycle when the reset is done
+  sht21State = SHT21_START;
+  sht21Errors = 0;
+  scheduler.schedule(TASK_SHT21, sht21.startReset());
+
+  // Without a valid CO2 value, the stored one is shown
+  if(co2Valid) {
+    co2Valid = false;
+    storedReading = FRAM::lastReading();
+  }
+  if(bootState == BOOT_FAILED) {
+    scheduler.cancel(TASK_ERROR);
+    digitalWrite(LED_RED, HIGH);
+  }
+  generalCallReset = false;
+  bootState = BOOT_SELFTEST;
+  scheduler.schedule(TASK_BOOT, 0);
+}
+
+#ifdef TELEMETRY
+//*********************************************************
+// Execute commands received from the host
+//*********************************************************
+void handleCommands() {
+
+  uint8_t type, length;
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+
+  while(telemetry.receiveFrame(&type, payload, &length)) {
+    if(type != TELEMETRY_FRAME_COMMAND || length < 1)
+      continue;
+    switch(payload[0]) {
+      case TELEMETRY_COMMAND_BURST:
+        if(length >= 2)
+          startBurst(payload[1]);
+        break;
+      case TELEMETRY_COMMAND_CONFIG:
+        // Takes effect with the next measurement
+        if(length == 1 + CONFIG_BLOCK_SIZE && Config::commit((const ConfigBlock *)&payload[1])) {
+          config = Config::active();
+          sendConfig(TELEMETRY_CONFIG_OK);
+        }
+        else
+          sendConfig(TELEMETRY_CONFIG_REJECTED);
+        break;
+      case TELEMETRY_COMMAND_GET_CONFIG:
+        sendConfig(TELEMETRY_CONFIG_OK);
+        break;
+      case TELEMETRY_COMMAND_EXPORT:
+        if(length >= 8)
+          startExport(payload);
+        break;
+      default: break;
+    }
+  }
+}
+
+//*********************************************************
+// Answer a config command with the active configuration
+//*********************************************************
+void sendConfig(uint8_t status) {
+
+  uint8_t payload[1 + CONFIG_BLOCK_SIZE];
+
+  payload[0] = status;
+  memcpy(&payload[1], config, CONFIG_BLOCK_SIZE);
+  telemetry.sendFrame(TELEMETRY_FRAME_CONFIG, payload, sizeof(payload));
+}
+
+//*********************************************************
+// Send stored records at a higher baud rate
+// [FIRST (4)][COUNT (2)][BAUD (1)], see RecordLog.h
+// The measurements keep running, one block per run. Not
+// during a burst, it allows no serial traffic.
+//*********************************************************
+void startExport(const uint8_t *arguments) {
+
+  uint32_t first = arguments[1] | (uint32_t)arguments[2] << 8 |
+                   (uint32_t)arguments[3] << 16 | (uint32_t)arguments[4] << 24;
+  uint16_t count = arguments[5] | arguments[6] << 8;
+  unsigned long baud = RecordLog::baudRate(arguments[7]);
+
+  if(baud == 0 || burst.isSampling() || burst.isDumping() || !recordLog.startExport(first, count))
+    return;
+  exportBaud = arguments[7];
+  // Give the host time to change its baud rate
+  Serial.flush();
+  Serial.begin(baud);
+  scheduler.schedule(TASK_EXPORT, LOG_SWITCH_TIME);
+}
+
+//*********************************************************
+// Send one block and come back when it's out, the UART
+// interrupt does the transmission meanwhile
+//*********************************************************
+void exportTask() {
+
+  unsigned int size = recordLog.sendBlock(&telemetry, config->logInterval);
+
+  if(size == 0) {
+    Serial.flush();
+    Serial.begin(TELEMETRY_BAUD);
+    return;
+  }
+  // 10 bits per byte
+  scheduler.schedule(TASK_EXPORT, size * 10000UL / RecordLog::baudRate(exportBaud) + 1);
+}
+
+//*********************************************************
+// Start a raw signal burst of the SGP30
+// Display, SHT21 and readings pause until it's over, the
+// 1 Hz air quality measurement keeps its slot.
+//*********************************************************
+void startBurst(uint8_t seconds) {
+
+  // SGP30 must be initialised, one burst at a time, no
+  // export sending meanwhile
+  if(bootState != BOOT_DONE || burst.isSampling() || burst.isDumping() || scheduler.isScheduled(TASK_EXPORT))
+    return;
+
+  scheduler.cancel(TASK_SHT21);
+  scheduler.cancel(TASK_ANIMATION);
+  lcd.showSymbol(LCD_SEG_RADIO, true);
+
+  burst.start(seconds);
+  scheduler.schedule(TASK_BURST, 0);
+}
+
+//*********************************************************
+// One raw signal measurement per run: read the result of
+// the last one and start the next one right away
+//*********************************************************
+void burstTask() {
+
+  uint16_t words[2];
+
+  if(sgp30.pendingCommand() == SGP30_CMD_MEASURE_SIGNALS) {
+    boolean valid = sgp30.finish(words);
+    if(!burst.store(valid, words[0], words[1])) {
+      stopBurst();
+      return;
+    }
+  }
+
+  // The SGP30 handles one command at a time, leave the
+  // next air quality measurement its slot
+  if(sgp30.isBusy()) {
+    scheduler.schedule(TASK_BURST, sgp30.dueIn());
+    return;
+  }
+  unsigned long next = scheduler.dueIn(TASK_SGP30);
+  if(next <= sgp30.command(SGP30_CMD_MEASURE_SIGNALS)->duration + 1) {
+    scheduler.schedule(TASK_BURST, next);
+    return;
+  }
+  scheduler.schedule(TASK_BURST, sgp30.start(SGP30_CMD_MEASURE_SIGNALS));
+}
+
+//*********************************************************
+// Resume normal operation and dump the burst
+//*********************************************************
+void stopBurst() {
+
+  lcd.showSymbol(LCD_SEG_RADIO, false);
+  sht21State = SHT21_START;
+  scheduler.schedule(TASK_SHT21, 0);
+  if(!co2Valid)
+    scheduler.schedule(TASK_ANIMATION, 0);
+  scheduler.schedule(TASK_DUMP, 0);
+}
+
+//*********************************************************
+// Send the burst, one frame per run
+//*********************************************************
+void dumpTask() {
+
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+  uint8_t length = burst.encodeDump(payload);
+
+  if(length == 0)
+    return;
+  telemetry.sendFrame(TELEMETRY_FRAME_BURST, payload, length);
+  scheduler.schedule(TASK_DUMP, BURST_DUMP_INTERVAL);
+}
+#endif
+
+//*********************************************************
+// Show the selected screen
+// The clock marks values stored before the reset.
+//*********************************************************
+void showValues() {
 
   if(!show_max) {
     switch(screen) {
       case SCREEN_CO2:
-        gui.showCO2(SGP30_CO2); break;
+        if(SGP30_CO2 == 0 && !storedReading && bootState != BOOT_FAILED)
+          return;   // animationTask() shows the boot text
+        gui.showCO2(co2Valid || !storedReading ? SGP30_CO2 : storedReading->co2);
+        lcd.showSymbol(LCD_SEG_CLOCK, !co2Valid && storedReading);
+        break;
       case SCREEN_TEMP:
-        gui.showTemperature(temperature); break;
+        gui.showTemperature(temperature);
+        lcd.showSymbol(LCD_SEG_CLOCK, !climateValid);
+        break;
       case SCREEN_RH:
-        gui.showHumidity(humidity); break;
+        gui.showHumidity(humidity);
+        lcd.showSymbol(LCD_SEG_CLOCK, !climateValid);
+        break;
       default: break;
     }
   }
@@ -149,44 +823,8 @@ void loop() {
     }
     lcd.showSymbol(LCD_SEG_MARK, true);
   }
-
-  // Show maximum values if left button is pressed
-  if(leftButton && !rightButton) {
-    if(show_max)
-      show_max = false;
-    else
-      show_max = true;
-    leftButton = false;
-    // Re-enable left button interrupt
-    attachInterrupt(PUSH1, _button1ISR, FALLING);
-  }
-  //Switch to next screen if right button is pressed
-  if(rightButton && !leftButton) {
-    if(screen < 3)
-      screen++;
-    else
-      screen = 1;
-    rightButton = false;
-    // Re-enable right button interrupt
-    attachInterrupt(PUSH2, _button2ISR, FALLING);
-  }
-  // Delete maximum values if right button is held down
-  if(rightButton && leftButton) {
-    temperature_max = 0;
-    humidity_max = 0;
-    CO2_max = 0;
-    rightButton = false;
-    leftButton = false;
-   
-    // Wait until buttons are released
-    while(!digitalRead(PUSH1) && !digitalRead(PUSH2)) {
-    }
-    // Re-enable left and right button interrupt
-    attachInterrupt(PUSH1, _button1ISR, FALLING);
-    attachInterrupt(PUSH2, _button2ISR, FALLING);
-  }
-  
-  sleep(MEAS_INTERVAL);
+  if(!co2Valid && bootState != BOOT_FAILED)
+    lcd.showSymbol(LCD_SEG_HEART, animationStep & 1);
 }
 
 // Function is called when button S1 is pressed
@@ -194,6 +832,8 @@ void _button1ISR() {
   leftButton = true;
   // Disable this interrupt
   detachInterrupt(PUSH1);
+  // Leave low power mode
+  wakeup();
 }
 
 // Function is called when button S2 is changed
@@ -201,5 +841,7 @@ void _button2ISR() {
   rightButton = true;
   // Disable this interrupt
   detachInterrupt(PUSH2);
+  // Leave low power mode
+  wakeup();
 }
 